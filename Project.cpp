@@ -7,6 +7,25 @@
 #include <fstream>
 #include <sstream>
 #include <iomanip>
+#include <new>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+
+// SSE2 is part of every x64 target, but MSVC never defines __SSE2__: check its own macros too
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HAS_SSE2 1
+#endif
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#elif defined(HAS_SSE2)
+#include <emmintrin.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>     // _BitScanForward / _BitScanReverse64
+#endif
 
 // Detect OS for Clear Screen
 #ifdef _WIN32
@@ -50,6 +69,10 @@ const int STATUS_MISSING = 7;
 const int STATUS_CANCELLED = 8;
 const int STATUS_UNDER_INVESTIGATION = 9;
 
+// Dispatch SLA per priority (index 1..3), in real seconds after the request is created.
+// At the simulation's 30 minutes per second these are 48h / 24h / 6h of simulated time.
+const int SLA_DISPATCH_SECONDS[4] = { 0, 96, 48, 12 };
+
 void clearScreen() 
 {
     system(CLEAR_CMD);
@@ -96,175 +119,19 @@ struct Rider
     int capacity;
     int currentLoad;
     int priorityLevel; // 1=Standard, 2=Express/Urgent
+    int id;                 // Stable index in the RiderPool
+    long long lastAssigned; // Pool-wide sequence number of the rider's latest assignment
+    int heapSlot;           // Position in the pool's free heap (-1 when full or reserved)
+    double maxWeight;       // kg one trip can carry
+    double loadWeight;      // kg currently on board
+    string zone;            // Home zone
+    int shard;              // Zone shard of the pool the rider sits in
     
-    Rider(string n="", int c=3, int p=1) : name(n), capacity(c), currentLoad(0), priorityLevel(p) {}
-};
-
-// Queue for Rider Objects
-class RiderQueue 
-{
-// Node must be accessible to RiderQueue methods
-private:
-    struct Node { Rider value; Node* next; Node(Rider v) : value(v), next(nullptr) {} };
-    Node* front;
-    Node* rear;
-    
-public:
-    RiderQueue() : front(nullptr), rear(nullptr) {}
-    
-    void enqueue(Rider val) 
-    {
-        Node* newNode = new Node(val);
-        if (rear) rear->next = newNode;
-        else front = newNode;
-        rear = newNode;
-    }
-    
-    Rider dequeue() 
-    {
-        if (!front) return Rider();
-        Rider value = front->value;
-        Node* temp = front;
-        front = front->next;
-        if (!front) rear = nullptr;
-        delete temp;
-        return value;
-    }
-    
-    // Peek to see front rider
-    Rider* peek() 
-    {
-        if(!front) return nullptr;
-        return &(front->value);
-    }
-    
-    bool isEmpty() { return front == nullptr; }
-    
-    // Rotate queue: pop front and push to back
-    void rotate() 
-    {
-        if(!front || front == rear) return;
-        Rider r = dequeue();
-        enqueue(r);
-    }
-
-    // New: Simple display function
-    void displayAll()
-    {
-        if(!front) { cout << "No riders avaliable.\n"; return; }
-        
-        cout << "\n----------------------------------------\n";
-        cout << "            RIDER FLEET DETAILS         \n";
-        cout << " [Types: Standard = Priority 1, Express = Priority 2] \n";
-        cout << "----------------------------------------\n";
-        cout << left << setw(20) << "Name" << setw(10) << "Type" << setw(15) << "Load Status" << endl;
-        cout << "----------------------------------------\n";
-        
-        Node* curr = front;
-        while(curr)
-        {
-            string type = (curr->value.priorityLevel == 2) ? "Express" : "Standard";
-            cout << left << setw(20) << curr->value.name 
-                 << setw(10) << type 
-                 << curr->value.currentLoad << "/" << curr->value.capacity << " Parcels" << endl;
-            curr = curr->next;
-        }
-        cout << "----------------------------------------\n";
-    }
-
-    void exportJSON(ofstream& out)
-    {
-        Node* curr = front;
-        bool first = true;
-        while(curr)
-        {
-            if(!first) out << ",\n";
-            string type = (curr->value.priorityLevel == 2) ? "Express" : "Standard";
-            out << "    { \"name\": \"" << curr->value.name << "\", \"type\": \"" << type 
-                << "\", \"load\": " << curr->value.currentLoad << ", \"capacity\": " << curr->value.capacity << " }";
-            first = false;
-            curr = curr->next;
-        }
-    }
-    
-    // Simple helper to find a suitable rider without complex logic
-    // Returns pointer to rider in queue if found (by rotating until match or full circle)
-    Rider* findAvailableRider(int parcelPriority)
-    {
-        if(!front) return nullptr;
-        
-        Node* curr = front;
-        int count = 0;
-        int size = 0;
-        
-        // Count size first
-        Node* temp = front;
-        while(temp) { size++; temp = temp->next; }
-        
-        // Try to find best match
-        for(int i=0; i<size; i++)
-        {
-            Rider* r = peek();
-            
-            // Check capacity
-            if(r->currentLoad < r->capacity)
-            {
-                // Simple Priority Logic: 
-                // If parcel is High Priority (3), look for Express Rider (Level 2)
-                // If standard (1 or 2), any rider works.
-                if(parcelPriority == 3)
-                {
-                    if(r->priorityLevel >= 2) return r; // Good match
-                }
-                else
-                {
-                    return r; // Any rider acts
-                }
-            }
-            
-            // Rotate to check next
-            rotate();
-        }
-        
-        // Final pass: just find ANY with capacity if strict match failed
-        for(int i=0; i<size; i++)
-        {
-            Rider* r = peek();
-            if(r->currentLoad < r->capacity) return r;
-            rotate();
-        }
-        
-        return nullptr;
-    }
-    
-    // Decrement load for a rider
-    void decrementLoad(string name)
-    {
-        Node* curr = front;
-        while(curr)
-        {
-            if(curr->value.name == name)
-            {
-                if(curr->value.currentLoad > 0) curr->value.currentLoad--;
-                return;
-            }
-            curr = curr->next;
-        }
-    }
-    
-    // Destructor to prevent memory leak
-    ~RiderQueue() 
-    {
-        while(front) 
-        {
-            Node* temp = front;
-            front = front->next;
-            delete temp;
-        }
-    }
+    Rider(string n="", int c=3, int p=1, double kg=50, string z="") : name(n), capacity(c), currentLoad(0), priorityLevel(p), 
+                                                                      id(-1), lastAssigned(0), heapSlot(-1), maxWeight(kg), 
+                                                                      loadWeight(0), zone(z), shard(0) {}
 };
 
-
 struct HistoryEvent 
 {
     string description;
@@ -329,6 +196,20 @@ public:
 };
 
 
+class IntArrayList;
+class ParcelIndexes;
+
+// Secondary indexes kept on the parcel database (see ParcelIndexes)
+const int INDEX_STATUS = 0;
+const int INDEX_DESTINATION = 1;
+const int INDEX_ZONE = 2;
+const int INDEX_RIDER = 3;
+const int INDEX_KINDS = 4;
+const int STATUS_COUNT = 10;
+
+typedef unsigned int ParcelHandle;          // Interned parcel ID (see ParcelHashTable)
+const ParcelHandle NO_PARCEL = 0xFFFFFFFFu;
+
 struct Parcel 
 {
     string id;
@@ -338,6 +219,7 @@ struct Parcel
     int status;
     int priorityScore;
     string assignedRider;
+    int assignedRiderId;    // RiderPool ID of assignedRider (-1 if none)
     
     string weightCategory; 
     string zone;           
@@ -346,15 +228,40 @@ struct Parcel
     long long dispatchTime; 
     long long lastUpdateTime; 
     long long arrivalTime;
+    long long signalLossTime;   // In transit: when its tracking signal drops (sampled on departure)
+    long long nextEventTime;    // Due time of its pending lifecycle event
+    int eventSlot;              // Position in the lifecycle timers (-1 when none is pending)
+    
+    IntArrayList* route;    // City indices of the dispatched route (nullptr until dispatch)
+    int routeDistance;      // Total km of 'route'
+    int originHub;          // Hub slot the parcel ships from (-1 until assigned)
+    int shard;              // Zone shard of its hub queue (set when enqueued)
+    int heapSlot;           // Position in its hub's sorting queue (-1 when not queued)
+    int queueKey;           // Bucket holding it in a BucketParcelQueue (-1 otherwise)
+    long long createdTime;  
+    long long slaDeadline;  // Must leave its hub by this time (createdTime + SLA of its priority)
+    ParcelIndexes* indexes;         // Indexes of the database holding it (nullptr if none)
+    int indexKey[INDEX_KINDS];      // Set it sits in, per index (-1 if none)
+    int indexSlot[INDEX_KINDS];     // Position inside that set
+    ParcelHandle handle;            // Interned ID in the database (NO_PARCEL until stored)
     
     TrackingHistory* history; 
     
-    Parcel() : weight(0), priority(1), status(0), priorityScore(0), history(new TrackingHistory()), dispatchTime(0), lastUpdateTime(0), arrivalTime(0), deliveryAttempts(0) {}
+    Parcel() : weight(0), priority(1), status(0), priorityScore(0), assignedRiderId(-1), deliveryAttempts(0), dispatchTime(0), lastUpdateTime(0), arrivalTime(0), 
+               signalLossTime(LLONG_MAX), nextEventTime(0), eventSlot(-1), route(nullptr), routeDistance(0), originHub(-1), shard(-1), heapSlot(-1), queueKey(-1), createdTime(0), slaDeadline(0), 
+               indexes(nullptr), handle(NO_PARCEL), history(new TrackingHistory()) 
+    {
+        for (int k = 0; k < INDEX_KINDS; k++) 
+        indexKey[k] = indexSlot[k] = -1;
+    }
     
-    Parcel(string pid, string dest, double w, int p, string z) : id(pid), destination(dest), weight(w), priority(p), status(STATUS_PICKUP_QUEUE), lastUpdateTime(0), arrivalTime(0), zone(z), deliveryAttempts(0), dispatchTime(0) 
+    Parcel(string pid, string dest, double w, int p, string z) : id(pid), destination(dest), weight(w), priority(p), status(STATUS_PICKUP_QUEUE), assignedRiderId(-1), zone(z), deliveryAttempts(0), dispatchTime(0), lastUpdateTime(0), arrivalTime(0), signalLossTime(LLONG_MAX), nextEventTime(0), eventSlot(-1), route(nullptr), routeDistance(0), originHub(-1), shard(-1), heapSlot(-1), queueKey(-1), createdTime(time(0)), indexes(nullptr), handle(NO_PARCEL) 
     {
+        for (int k = 0; k < INDEX_KINDS; k++) 
+        indexKey[k] = indexSlot[k] = -1;
         
         priorityScore = p * 1000 + (int)w; 
+        slaDeadline = createdTime + slaSeconds(p);
         
         if (w < 5.0) 
         weightCategory = "Light";
@@ -368,12 +275,22 @@ struct Parcel
         history->addEvent("Pickup Request Created", "Customer Loc");
     }
     
-    void updateStatus(int newStatus, string desc, string loc) 
+    static int slaSeconds(int p) 
+    {
+        return SLA_DISPATCH_SECONDS[p < 1 ? 1 : (p > 3 ? 3 : p)];
+    }
+    
+    // Caller must re-position the parcel in its sorting queue (ParcelHeap::update)
+    void setPriority(int p) 
     {
-        status = newStatus;
-        history->addEvent(desc, loc);
-        lastUpdateTime = time(0);
+        priority = p;
+        priorityScore = p * 1000 + (int)weight;
+        slaDeadline = createdTime + slaSeconds(p);
     }
+    
+    // Both keep the database's status / rider indexes in step
+    void updateStatus(int newStatus, string desc, string loc);
+    void assignRider(const string& name, int riderId);
 
     string getStatusString() const 
     {
@@ -516,6 +433,12 @@ public:
         return (index >= 0 && index < count) ? data[index] : -1;
     }
     
+    void set(int index, int val) 
+    {
+        if (index >= 0 && index < count) 
+        data[index] = val; 
+    }
+    
     int size() const 
     {
         return count; 
@@ -525,6 +448,331 @@ public:
     { 
         return count == 0; 
     }
+    
+    void clear() 
+    { 
+        count = 0; 
+    }
+    
+    void removeLast() 
+    {
+        if (count > 0) count--; 
+    }
+    
+    // Reverse in place (paths are rebuilt backwards from predecessor links)
+    void reverse() 
+    {
+        for (int i = 0, j = count - 1; i < j; i++, j--) 
+        {
+            int temp = data[i]; 
+            data[i] = data[j]; 
+            data[j] = temp;
+        }
+    }
+};
+
+// Rider fleet indexed by stable integer IDs (position in the pool).
+// Riders with spare capacity sit in one indexed min-heap per zone shard and service level,
+// keyed by (current load, assignment sequence, ID): the least loaded rider wins and ties go to
+// whoever was assigned longest ago, which keeps the old round-robin rotation fair.
+// Find within a shard is O(1), fleet-wide it is O(shards); assign and release are O(log n).
+// Full riders leave their heap until released. Work on different shards touches disjoint heaps
+// and riders, so one dispatch worker per shard can run without locking the pool.
+class RiderPool 
+{
+private:
+    Rider* riders; 
+    int count; 
+    int capacity;
+    IntArrayList* freeHeap;         // [shard * 3 + level], level 1 = Standard, 2 = Express; rider IDs
+    int shardCount;
+    std::atomic<long long> assignSeq;
+    
+    static int levelOf(const Rider& r) 
+    {
+        return r.priorityLevel >= 2 ? 2 : 1;
+    }
+    
+    IntArrayList& heapOf(const Rider& r) 
+    {
+        return freeHeap[r.shard * 3 + levelOf(r)];
+    }
+    
+    void ensureShards(int n) 
+    {
+        if (n <= shardCount) 
+        return;
+        IntArrayList* grown = new IntArrayList[n * 3];
+        for (int i = 0; i < shardCount * 3; i++) 
+        for (int j = 0; j < freeHeap[i].size(); j++) 
+        grown[i].add(freeHeap[i].get(j));
+        delete[] freeHeap;
+        freeHeap = grown;
+        shardCount = n;
+    }
+    
+    bool less(int a, int b) const 
+    {
+        if (riders[a].currentLoad != riders[b].currentLoad) 
+        return riders[a].currentLoad < riders[b].currentLoad;
+        if (riders[a].lastAssigned != riders[b].lastAssigned) 
+        return riders[a].lastAssigned < riders[b].lastAssigned;
+        return a < b;
+    }
+    
+    void place(IntArrayList& heap, int index, int id) 
+    {
+        heap.set(index, id);
+        riders[id].heapSlot = index;
+    }
+    
+    void siftUp(IntArrayList& heap, int index) 
+    {
+        int id = heap.get(index);
+        while (index > 0) 
+        {
+            int parent = (index - 1) / 2;
+            if (!less(id, heap.get(parent))) 
+            break;
+            place(heap, index, heap.get(parent));
+            index = parent;
+        }
+        place(heap, index, id);
+    }
+    
+    void siftDown(IntArrayList& heap, int index) 
+    {
+        int id = heap.get(index);
+        int n = heap.size();
+        while (2 * index + 1 < n) 
+        {
+            int child = 2 * index + 1;
+            if (child + 1 < n && less(heap.get(child + 1), heap.get(child))) 
+            child++;
+            if (!less(heap.get(child), id)) 
+            break;
+            place(heap, index, heap.get(child));
+            index = child;
+        }
+        place(heap, index, id);
+    }
+    
+    void heapRemove(IntArrayList& heap, int id) 
+    {
+        int index = riders[id].heapSlot;
+        int last = heap.get(heap.size() - 1);
+        heap.removeLast();
+        riders[id].heapSlot = -1;
+        if (last != id) 
+        {
+            place(heap, index, last);
+            siftUp(heap, index);
+            siftDown(heap, riders[last].heapSlot);
+        }
+    }
+    
+    // Put a rider in, out of, or back in order within its level's heap after its load changed
+    void refresh(int id) 
+    {
+        Rider& r = riders[id];
+        IntArrayList& heap = heapOf(r);
+        bool hasRoom = r.currentLoad < r.capacity;
+        if (r.heapSlot == -1) 
+        {
+            if (hasRoom) 
+            {
+                heap.add(id);
+                siftUp(heap, heap.size() - 1);
+            }
+        }
+        else if (!hasRoom) 
+        heapRemove(heap, id);
+        else 
+        {
+            siftUp(heap, r.heapSlot);
+            siftDown(heap, r.heapSlot);
+        }
+    }
+    
+    // Can the rider take 'kg' more? An empty rider takes any single parcel, however heavy.
+    static bool fits(const Rider& r, double kg) 
+    {
+        return r.currentLoad == 0 || r.loadWeight + kg <= r.maxWeight;
+    }
+    
+    // Best rider with room for 'kg' in the subtree at 'index'. A rider that fits outranks
+    // everyone below it, so only the branches under riders that are too heavy are searched.
+    Rider* bestFit(IntArrayList& heap, int index, double kg) 
+    {
+        if (index >= heap.size()) 
+        return nullptr;
+        Rider& r = riders[heap.get(index)];
+        if (fits(r, kg)) 
+        return &r;
+        Rider* best = nullptr;
+        for (int c = 2 * index + 1; c <= 2 * index + 2; c++) 
+        {
+            Rider* found = bestFit(heap, c, kg);
+            if (found && (!best || less(found->id, best->id))) 
+            best = found;
+        }
+        return best;
+    }
+    
+    Rider* topOf(int shard, int level, double kg) 
+    {
+        return bestFit(freeHeap[shard * 3 + level], 0, kg);
+    }
+    
+    // Best rider of a level over every shard
+    Rider* bestOf(int level, double kg) 
+    {
+        Rider* best = nullptr;
+        for (int s = 0; s < shardCount; s++) 
+        {
+            Rider* top = topOf(s, level, kg);
+            if (top && (!best || less(top->id, best->id))) 
+            best = top;
+        }
+        return best;
+    }
+    
+    Rider* pick(Rider* express, Rider* standard, int parcelPriority) 
+    {
+        if (parcelPriority == 3 && express) 
+        return express;
+        if (!standard) return express;
+        if (!express) return standard;
+        return less(express->id, standard->id) ? express : standard;
+    }
+
+public:
+    RiderPool() : count(0), capacity(16), freeHeap(nullptr), shardCount(0), assignSeq(0) 
+    {
+        riders = new Rider[capacity];
+        ensureShards(1);
+    }
+    
+    ~RiderPool() 
+    {
+        delete[] riders;
+        delete[] freeHeap;
+    }
+    
+    // Returns the new rider's ID
+    int addRider(const Rider& val) 
+    {
+        if (count == capacity) 
+        {
+            Rider* newRiders = new Rider[capacity * 2];
+            for (int i = 0; i < count; i++) 
+            newRiders[i] = riders[i];
+            delete[] riders; 
+            riders = newRiders; 
+            capacity *= 2;
+        }
+        int id = count++;
+        riders[id] = val;
+        riders[id].id = id;
+        riders[id].heapSlot = -1;
+        if (riders[id].shard < 0) riders[id].shard = 0;
+        ensureShards(riders[id].shard + 1);
+        refresh(id);
+        return id;
+    }
+    
+    int size() const 
+    { 
+        return count; 
+    }
+    
+    Rider* get(int id) 
+    {
+        return (id >= 0 && id < count) ? &riders[id] : nullptr;
+    }
+    
+    int getShardCount() const 
+    {
+        return shardCount;
+    }
+    
+    // Urgent parcels (priority 3) go to an Express rider if one has room, otherwise to any
+    // rider; other parcels take the best rider of either level. Riders the parcel's weight
+    // would push over maxWeight are skipped. nullptr if the fleet is full.
+    Rider* findAvailableRider(int parcelPriority, double weight) 
+    {
+        return pick(bestOf(2, weight), bestOf(1, weight), parcelPriority);
+    }
+    
+    // Same choice among the riders of one zone shard only
+    Rider* findAvailableRider(int parcelPriority, double weight, int shard) 
+    {
+        if (shard < 0 || shard >= shardCount) 
+        return nullptr;
+        return pick(topOf(shard, 2, weight), topOf(shard, 1, weight), parcelPriority);
+    }
+    
+    void assign(Rider* r, double kg) 
+    {
+        r->currentLoad++;
+        r->loadWeight += kg;
+        r->lastAssigned = ++assignSeq;
+        refresh(r->id);
+    }
+    
+    // Hold a rider back from findAvailableRider while a trip for it is being packed
+    void reserve(Rider* r) 
+    {
+        if (r->heapSlot != -1) 
+        heapRemove(heapOf(*r), r->id);
+    }
+    
+    void unreserve(Rider* r) 
+    {
+        refresh(r->id);
+    }
+    
+    void release(int id, double kg) 
+    {
+        if (id < 0 || id >= count || riders[id].currentLoad == 0) 
+        return;
+        riders[id].currentLoad--;
+        riders[id].loadWeight = (riders[id].currentLoad == 0) ? 0 : riders[id].loadWeight - kg;
+        refresh(id);
+    }
+    
+    void displayAll()
+    {
+        if(count == 0) { cout << "No riders avaliable.\n"; return; }
+        
+        cout << "\n----------------------------------------\n";
+        cout << "            RIDER FLEET DETAILS         \n";
+        cout << " [Types: Standard = Priority 1, Express = Priority 2] \n";
+        cout << "----------------------------------------\n";
+        cout << left << setw(6) << "ID" << setw(20) << "Name" << setw(10) << "Type" << setw(10) << "Zone" << setw(15) << "Load Status" << endl;
+        cout << "----------------------------------------\n";
+        
+        for(int i=0; i<count; i++)
+        {
+            string type = (riders[i].priorityLevel == 2) ? "Express" : "Standard";
+            cout << left << setw(6) << riders[i].id << setw(20) << riders[i].name 
+                 << setw(10) << type << setw(10) << riders[i].zone 
+                 << riders[i].currentLoad << "/" << riders[i].capacity << " Parcels, " 
+                 << riders[i].loadWeight << "/" << riders[i].maxWeight << " kg" << endl;
+        }
+        cout << "----------------------------------------\n";
+    }
+
+    void exportJSON(ofstream& out)
+    {
+        for(int i=0; i<count; i++)
+        {
+            if(i > 0) out << ",\n";
+            string type = (riders[i].priorityLevel == 2) ? "Express" : "Standard";
+            out << "    { \"id\": " << riders[i].id << ", \"name\": \"" << riders[i].name << "\", \"type\": \"" << type 
+                << "\", \"zone\": \"" << riders[i].zone << "\", \"load\": " << riders[i].currentLoad << ", \"capacity\": " << riders[i].capacity << " }";
+        }
+    }
 };
 
 class ParcelArrayList 
@@ -594,10 +842,195 @@ public:
         data[i] = data[j]; 
         data[j] = temp; 
     }
+    
+    // Remove by moving the last entry into the hole (order is not preserved)
+    void removeAt(int index) 
+    {
+        if (index < 0 || index >= count) 
+        return;
+        data[index] = data[--count];
+    }
 };
 
 
-// Forward declaration for rider stats tracking
+// Orderings of an IndexedParcelHeap
+const int HEAP_ORDER_SCORE = 0;     // Highest priorityScore first
+const int HEAP_ORDER_DEADLINE = 1;  // Earliest SLA deadline first, then highest priorityScore
+const int HEAP_ORDER_EVENT = 2;     // Earliest nextEventTime first
+
+// Indexed 4-ary heap of parcels. Every parcel in it stores its slot (heapSlot, or eventSlot
+// for the lifecycle-event ordering, so a parcel can sit in a sorting queue and the event
+// timers at once), so removing or re-keying a parcel is an in-place O(log n) operation and
+// the heap never holds stale or duplicate entries. The 4-way fan-out halves the depth of a
+// binary heap and keeps each node's children in one or two cache lines.
+class IndexedParcelHeap 
+{
+private:
+    ParcelArrayList heap;
+    int order;
+    
+    int& slotOf(Parcel* p) const 
+    {
+        return order == HEAP_ORDER_EVENT ? p->eventSlot : p->heapSlot;
+    }
+    
+    // Should 'a' come out before 'b'?
+    bool above(Parcel* a, Parcel* b) const 
+    {
+        if (order == HEAP_ORDER_EVENT) 
+        return a->nextEventTime < b->nextEventTime;
+        if (order == HEAP_ORDER_DEADLINE && a->slaDeadline != b->slaDeadline) 
+        return a->slaDeadline < b->slaDeadline;
+        return a->priorityScore > b->priorityScore;
+    }
+    
+    void place(int index, Parcel* p) 
+    {
+        heap.set(index, p);
+        slotOf(p) = index;
+    }
+    
+    void heapifyUp(int index) 
+    {
+        Parcel* p = heap.get(index);
+        while (index > 0) 
+        {
+            int parent = (index - 1) / 4;
+            if (!above(p, heap.get(parent))) 
+            break;
+            place(index, heap.get(parent));
+            index = parent;
+        }
+        place(index, p);
+    }
+    
+    void heapifyDown(int index) 
+    {
+        Parcel* p = heap.get(index);
+        int n = heap.size();
+        while (true) 
+        {
+            int first = 4 * index + 1;
+            if (first >= n) 
+            break;
+            int best = first;
+            int last = (first + 4 < n) ? first + 4 : n;
+            for (int c = first + 1; c < last; c++) 
+            if (above(heap.get(c), heap.get(best))) 
+            best = c;
+            if (!above(heap.get(best), p)) 
+            break;
+            place(index, heap.get(best));
+            index = best;
+        }
+        place(index, p);
+    }
+    
+    bool owns(Parcel* p) const 
+    {
+        int slot = slotOf(p);
+        return slot >= 0 && slot < heap.size() && heap.get(slot) == p;
+    }
+
+public:
+    IndexedParcelHeap(int heapOrder) : order(heapOrder) {}
+    
+    // Inserting a parcel that is already in the heap just refreshes its position
+    void insert(Parcel* val) 
+    { 
+        if (owns(val)) 
+        {
+            update(val);
+            return;
+        }
+        heap.add(val); 
+        heapifyUp(heap.size() - 1); 
+    }
+    
+    Parcel* extractTop() 
+    {
+        if (heap.isEmpty()) 
+        return nullptr;
+        
+        Parcel* top = heap.get(0);
+        remove(top);
+        return top;
+    }
+    
+    // Take a parcel out wherever it sits. Returns false if it was not in this heap.
+    bool remove(Parcel* p) 
+    {
+        if (!owns(p)) 
+        return false;
+        
+        int index = slotOf(p);
+        Parcel* last = heap.get(heap.size() - 1);
+        heap.removeLast();
+        slotOf(p) = -1;
+        if (last != p) 
+        {
+            place(index, last);
+            heapifyUp(index);
+            heapifyDown(slotOf(last));
+        }
+        return true;
+    }
+    
+    // Restore heap order after the parcel's key changed (up or down)
+    void update(Parcel* p) 
+    {
+        if (!owns(p)) 
+        return;
+        heapifyUp(slotOf(p));
+        heapifyDown(slotOf(p));
+    }
+    
+    bool contains(Parcel* p) const 
+    {
+        return owns(p);
+    }
+    
+    Parcel* peekTop() const 
+    {
+        return heap.isEmpty() ? nullptr : heap.get(0);
+    }
+    
+    int size() const 
+    { 
+        return heap.size(); 
+    }
+    
+    bool isEmpty() const 
+    { 
+        return heap.isEmpty(); 
+    }
+};
+
+// Pending lifecycle events of shipped parcels, earliest first. A parcel has at most one.
+class LifecycleTimers 
+{
+private:
+    IndexedParcelHeap heap;
+
+public:
+    LifecycleTimers() : heap(HEAP_ORDER_EVENT) {}
+    
+    // Sets (or moves) the parcel's pending event to time 'at'
+    void schedule(Parcel* p, long long at) 
+    {
+        p->nextEventTime = at;
+        heap.insert(p);
+    }
+    
+    Parcel* extractMin() { return heap.extractTop(); }
+    // Drops the parcel's pending event, if any
+    void cancel(Parcel* p) { heap.remove(p); }
+    Parcel* peekMin() { return heap.peekTop(); }
+    int size() { return heap.size(); }
+    bool isEmpty() { return heap.isEmpty(); }
+};
+
+// Forward declaration for rider stats tracking
 class LogisticsEngine;
 
 struct ParcelNode 
@@ -613,10 +1046,43 @@ class ParcelLinkedList
 private:
     ParcelNode* head; 
     ParcelNode* tail;
+    LifecycleTimers timers;     // Next lifecycle event of every parcel still on its way
+    
+    // When the parcel's next lifecycle step is due, or -1 once it has left the lifecycle
+    static long long eventTime(Parcel* p) 
+    {
+        switch (p->status) 
+        {
+            case STATUS_LOADING: return p->lastUpdateTime + 5;
+            case STATUS_IN_TRANSIT: return p->signalLossTime < p->arrivalTime ? p->signalLossTime : p->arrivalTime;
+            case STATUS_DELIVERY_ATTEMPT: return p->lastUpdateTime; // Resolved on the next tick
+            default: return -1;
+        }
+    }
+    
+    // A parcel in transit loses its signal with a 1 in 1000 chance per second: draw the second
+    // it happens (geometric distribution) instead of rolling the dice on every tick
+    static long long sampleSignalLoss(long long from) 
+    {
+        double u = (rand() + 1.0) / (RAND_MAX + 1.0);
+        return from + 1 + (long long)(log(u) / log(0.999));
+    }
+    
+    void advance(Parcel* p, long long currentTime, LogisticsEngine* engine);
     
 public:
     ParcelLinkedList() : head(nullptr), tail(nullptr) {}
     
+    ~ParcelLinkedList() 
+    {
+        while (head) 
+        {
+            ParcelNode* next = head->next;
+            delete head;
+            head = next;
+        }
+    }
+    
     void pushBack(Parcel* val) 
     {
         ParcelNode* newNode = new ParcelNode(val);
@@ -628,9 +1094,45 @@ public:
         { 
             tail->next = newNode; tail = newNode; 
         }
+        reschedule(val);
+    }
+    
+    // Takes the parcel off the list along with its pending event (undo of a dispatch)
+    void remove(Parcel* p) 
+    {
+        timers.cancel(p);
+        ParcelNode* prev = nullptr;
+        ParcelNode* curr = head;
+        while (curr && curr->data != p) 
+        {
+            prev = curr;
+            curr = curr->next;
+        }
+        if (!curr) 
+        return;
+        if (prev) prev->next = curr->next; 
+        else head = curr->next;
+        if (tail == curr) tail = prev;
+        delete curr;
+    }
+    
+    // Re-reads the parcel's next event time, e.g. after a reroute changed its arrival
+    void reschedule(Parcel* p) 
+    {
+        if (p->status == STATUS_IN_TRANSIT && p->signalLossTime == LLONG_MAX) 
+        p->signalLossTime = sampleSignalLoss(time(0));
+        long long at = eventTime(p);
+        if (at != -1) 
+        timers.schedule(p, at);
+    }
+    
+    int pendingEvents() 
+    {
+        return timers.size();
     }
 
-    void updateLifecycle(long long currentTime, LogisticsEngine* engine = nullptr);
+    // Returns the number of parcels advanced
+    int updateLifecycle(long long currentTime, LogisticsEngine* engine = nullptr);
 
     void showTransitStatus(long long currentTime)
     {
@@ -667,198 +1169,1041 @@ public:
     }
 };
 
+// Hub sorting queue: an indexed 4-ary max-heap on priorityScore (see IndexedParcelHeap), so
+// cancelling, re-prioritising or re-queuing a parcel is an in-place O(log n) operation.
+// In deadline mode the heap is ordered by SLA deadline instead (earliest deadline first).
+// Every waiting parcel's slack shrinks at the same rate, so ordering by deadline is ordering
+// by slack: parcels age without ever being re-keyed, and each one costs O(log n) in total.
 class ParcelHeap 
 {
 private:
-    ParcelArrayList heap;
-    void heapifyUp(int index) 
+    IndexedParcelHeap heap;
+
+public:
+    ParcelHeap(bool deadlineOrder = false) : heap(deadlineOrder ? HEAP_ORDER_DEADLINE : HEAP_ORDER_SCORE) {}
+    
+    // Inserting a parcel that is already queued just refreshes its position
+    void insert(Parcel* val) { heap.insert(val); }
+    Parcel* extractMax() { return heap.extractTop(); }
+    // Take a parcel out of the queue wherever it sits. Returns false if it was not queued here.
+    bool remove(Parcel* p) { return heap.remove(p); }
+    // Restore heap order after p->priorityScore changed (up or down)
+    void update(Parcel* p) { heap.update(p); }
+    bool contains(Parcel* p) { return heap.contains(p); }
+    Parcel* peekMax() { return heap.peekTop(); }
+    int size() { return heap.size(); }
+    bool isEmpty() { return heap.isEmpty(); }
+};
+
+// Index of the highest set bit of a non-zero word
+inline int highestBit(unsigned long long x) 
+{
+#if defined(_MSC_VER)
+    unsigned long idx;
+    _BitScanReverse64(&idx, x);
+    return (int)idx;
+#else
+    return 63 - __builtin_clzll(x);
+#endif
+}
+
+// Bucket queue keyed directly by priorityScore (priority * 1000 + weight), which only spans a
+// few thousand values. One bucket per key plus a two-level occupancy bitmap: insert and
+// removal are O(1), extract-max finds the top bucket with two bit scans. Scores beyond the
+// last bucket (parcels of 1000+ kg at the top priority) share it in arbitrary order.
+// Parcels in the same bucket come out in no particular order, as with the heap.
+class BucketParcelQueue 
+{
+private:
+    static const int BUCKETS = 4096;            // 64 words x 64 bits
+    
+    ParcelArrayList* buckets[BUCKETS];          // Allocated on first use
+    unsigned long long words[BUCKETS / 64];     // Bit k set = bucket k non-empty
+    unsigned long long summary;                 // Bit w set = words[w] non-zero
+    int count;
+    
+    static int keyOf(Parcel* p) 
     {
-        while (index > 0) 
+        int k = p->priorityScore;
+        return k < 0 ? 0 : (k >= BUCKETS ? BUCKETS - 1 : k);
+    }
+    
+    void take(Parcel* p) 
+    {
+        ParcelArrayList* list = buckets[p->queueKey];
+        int pos = p->heapSlot;
+        list->removeAt(pos);
+        if (pos < list->size()) 
+        list->get(pos)->heapSlot = pos;
+        if (list->isEmpty()) 
         {
-            int parent = (index - 1) / 2;
-            if (heap.get(index)->priorityScore > heap.get(parent)->priorityScore) 
-            {
-                heap.swap(index, parent); index = parent;
-            } 
-            else 
-            break;
+            int w = p->queueKey >> 6;
+            words[w] &= ~(1ULL << (p->queueKey & 63));
+            if (words[w] == 0) 
+            summary &= ~(1ULL << w);
         }
+        p->heapSlot = -1;
+        p->queueKey = -1;
+        count--;
     }
-    void heapifyDown(int index) 
+    
+    int topBucket() const 
     {
-        int left = 2 * index + 1, right = 2 * index + 2, largest = index;
-        
-        if (left < heap.size() && heap.get(left)->priorityScore > heap.get(largest)->priorityScore) 
-        largest = left;
-        if (right < heap.size() && heap.get(right)->priorityScore > heap.get(largest)->priorityScore) 
-        largest = right;
-        if (largest != index) 
-        { 
-            heap.swap(index, largest);
-            heapifyDown(largest);
-        }
+        int w = highestBit(summary);
+        return (w << 6) | highestBit(words[w]);
     }
 
 public:
+    BucketParcelQueue() : summary(0), count(0) 
+    {
+        for (int i = 0; i < BUCKETS; i++) 
+        buckets[i] = nullptr;
+        for (int i = 0; i < BUCKETS / 64; i++) 
+        words[i] = 0;
+    }
     
-    void insert(Parcel* val) 
-    { 
-        heap.add(val); 
-        heapifyUp(heap.size() - 1); 
+    ~BucketParcelQueue() 
+    {
+        for (int i = 0; i < BUCKETS; i++) 
+        delete buckets[i];
+    }
+    
+    bool contains(Parcel* p) 
+    {
+        return p->queueKey >= 0 && p->queueKey < BUCKETS && buckets[p->queueKey] && 
+               buckets[p->queueKey]->get(p->heapSlot) == p;
+    }
+    
+    void insert(Parcel* p) 
+    {
+        if (contains(p)) 
+        {
+            update(p);
+            return;
+        }
+        int k = keyOf(p);
+        if (!buckets[k]) 
+        buckets[k] = new ParcelArrayList();
+        p->queueKey = k;
+        p->heapSlot = buckets[k]->size();
+        buckets[k]->add(p);
+        words[k >> 6] |= 1ULL << (k & 63);
+        summary |= 1ULL << (k >> 6);
+        count++;
     }
     
     Parcel* extractMax() 
     {
-        if (heap.isEmpty()) 
+        if (count == 0) 
         return nullptr;
-        
-        Parcel* maxVal = heap.get(0);
-        heap.set(0, heap.get(heap.size() - 1));
-        heap.removeLast();
-        if (!heap.isEmpty()) 
-        heapifyDown(0);
-        
-        return maxVal;
+        ParcelArrayList* list = buckets[topBucket()];
+        Parcel* p = list->get(list->size() - 1);
+        take(p);
+        return p;
+    }
+    
+    Parcel* peekMax() 
+    {
+        if (count == 0) 
+        return nullptr;
+        ParcelArrayList* list = buckets[topBucket()];
+        return list->get(list->size() - 1);
+    }
+    
+    bool remove(Parcel* p) 
+    {
+        if (!contains(p)) 
+        return false;
+        take(p);
+        return true;
+    }
+    
+    // Move p to the bucket of its current priorityScore
+    void update(Parcel* p) 
+    {
+        if (!contains(p) || p->queueKey == keyOf(p)) 
+        return;
+        take(p);
+        insert(p);
+    }
+    
+    int size() 
+    { 
+        return count; 
     }
     
     bool isEmpty() 
     { 
-        return heap.isEmpty(); 
+        return count == 0; 
     }
 };
 
-struct HashEntry 
-{ string key; 
-    Parcel* value; 
+const int QUEUE_KIND_HEAP = 0;      // Indexed 4-ary heap
+const int QUEUE_KIND_BUCKET = 1;    // Bucket queue over priorityScore
+const int QUEUE_KIND_DEADLINE = 2;  // Indexed heap ordered by SLA deadline (EDF)
+
+// Hub sorting queue; the implementation is chosen once, when the queue is constructed
+class SortingQueue 
+{
+private:
+    int kind;
+    ParcelHeap* heap;
+    BucketParcelQueue* buckets;
+
+public:
+    SortingQueue(int k = QUEUE_KIND_HEAP) : kind(k), heap(nullptr), buckets(nullptr) 
+    {
+        if (kind == QUEUE_KIND_BUCKET) buckets = new BucketParcelQueue();
+        else heap = new ParcelHeap(kind == QUEUE_KIND_DEADLINE);
+    }
+    
+    ~SortingQueue() 
+    {
+        delete heap; 
+        delete buckets;
+    }
+    
+    int getKind() const { return kind; }
+    
+    // Order used by queues of 'kind': should 'a' be dispatched before 'b'?
+    static bool outranks(int kind, Parcel* a, Parcel* b) 
+    {
+        if (kind == QUEUE_KIND_DEADLINE && a->slaDeadline != b->slaDeadline) 
+        return a->slaDeadline < b->slaDeadline;
+        return a->priorityScore > b->priorityScore;
+    }
+    
+    void insert(Parcel* p) { if (heap) heap->insert(p); else buckets->insert(p); }
+    Parcel* extractMax() { return heap ? heap->extractMax() : buckets->extractMax(); }
+    Parcel* peekMax() { return heap ? heap->peekMax() : buckets->peekMax(); }
+    bool remove(Parcel* p) { return heap ? heap->remove(p) : buckets->remove(p); }
+    void update(Parcel* p) { if (heap) heap->update(p); else buckets->update(p); }
+    bool contains(Parcel* p) { return heap ? heap->contains(p) : buckets->contains(p); }
+    int size() { return heap ? heap->size() : buckets->size(); }
+    bool isEmpty() { return heap ? heap->isEmpty() : buckets->isEmpty(); }
+};
+
+// Hash index from a name to a dense integer id (djb2 + triangular probing over a power-of-two table).
+// Grows once half full, so lookups stay O(1) however many names are added.
+struct NameEntry 
+{ 
+    string key; 
+    int value; 
     bool occupied; 
-    HashEntry() : key(""), value(nullptr), occupied(false) {} 
+    NameEntry() : key(""), value(-1), occupied(false) {} 
 };
 
-class ParcelHashTable 
+class NameIndex 
 {
 private:
-    HashEntry* table; 
-    int capacity;
-    int hashFunction(const string& key) 
+    NameEntry* table; 
+    int capacity; 
+    int count;
+    
+    unsigned long hashFunction(const string& key) const 
     {
         unsigned long hash = 5381;
         for (char c : key) hash = ((hash << 5) + hash) + c; 
-        return hash % capacity;
+        return hash;
+    }
+    
+    // Slot holding 'key', or the empty slot where it would be inserted
+    int findSlot(const string& key) const 
+    {
+        int mask = capacity - 1;
+        int probe = (int)(hashFunction(key) & mask);
+        for (int i = 1; table[probe].occupied && table[probe].key != key; i++) 
+        probe = (probe + i) & mask;
+        return probe;
+    }
+    
+    void rehash(int newCapacity) 
+    {
+        NameEntry* old = table; 
+        int oldCapacity = capacity;
+        table = new NameEntry[newCapacity]; 
+        capacity = newCapacity;
+        for (int i = 0; i < oldCapacity; i++) 
+        {
+            if (old[i].occupied) 
+            table[findSlot(old[i].key)] = old[i];
+        }
+        delete[] old;
     }
 
 public:
+    NameIndex(int cap = 32) : capacity(cap), count(0) 
+    { 
+        table = new NameEntry[capacity]; 
+    }
     
-    ParcelHashTable(int cap = 1007) : capacity(cap) 
+    ~NameIndex() 
     { 
-        table = new HashEntry[capacity]; 
+        delete[] table; 
     }
     
-    ~ParcelHashTable() 
+    // Returns false if the name is already present
+    bool insert(const string& key, int value) 
     {
-        delete[] table; 
+        if ((count + 1) * 2 > capacity) 
+        rehash(capacity * 2);
+        
+        int slot = findSlot(key);
+        if (table[slot].occupied) 
+        return false;
+        
+        table[slot].key = key; 
+        table[slot].value = value; 
+        table[slot].occupied = true;
+        count++;
+        return true;
     }
     
-    void insert(string key, Parcel* value) 
+    int find(const string& key) const 
     {
-        int index = hashFunction(key); int i = 0;
-        while (i < capacity) 
+        int slot = findSlot(key);
+        return table[slot].occupied ? table[slot].value : -1;
+    }
+    
+    int size() const 
+    { 
+        return count; 
+    }
+};
+
+// Secondary indexes over the parcel database: status, destination, zone and rider, each mapping
+// a key to the set of parcels that currently have it. Every parcel records which set it sits in
+// and where (indexKey / indexSlot), so moving it between sets is a swap-remove plus an append.
+// Status and rider IDs are set numbers directly; destination and zone names get a dense set
+// number on first use. Parcel::updateStatus and Parcel::assignRider keep the sets current, so
+// a filtered walk costs O(matches) rather than O(table capacity).
+class ParcelIndexes 
+{
+private:
+    ParcelArrayList** sets[INDEX_KINDS];    // Set per key, created on first use
+    int setCount[INDEX_KINDS];
+    NameIndex destinations;
+    NameIndex zones;
+    
+    static int nameKey(NameIndex& names, const string& name) 
+    {
+        int key = names.find(name);
+        if (key == -1) 
         {
-            int probe = (index + i * i) % capacity;
-            if (!table[probe].occupied || table[probe].key == key) 
-            {
-                table[probe].key = key; table[probe].value = value; table[probe].occupied = true; return;
-            }
-            i++;
+            key = names.size();
+            names.insert(name, key);
         }
+        return key;
     }
     
-    Parcel* search(string key) 
+    int keyOf(Parcel* p, int kind) 
     {
-        int index = hashFunction(key); int i = 0;
-        while (i < capacity) 
+        switch (kind) 
         {
-            int probe = (index + i * i) % capacity;
-
-            if (!table[probe].occupied) 
-            return nullptr;
-            
-            if (table[probe].key == key) 
-            return table[probe].value;
-            i++;
+            case INDEX_STATUS: return p->status;
+            case INDEX_DESTINATION: return nameKey(destinations, p->destination);
+            case INDEX_ZONE: return nameKey(zones, p->zone);
+            default: return p->assignedRiderId;
         }
+    }
+    
+    ParcelArrayList* setFor(int kind, int key) 
+    {
+        if (key >= setCount[kind]) 
+        {
+            int newCount = setCount[kind] ? setCount[kind] : 8;
+            while (newCount <= key) newCount *= 2;
+            ParcelArrayList** grown = new ParcelArrayList*[newCount];
+            for (int i = 0; i < newCount; i++) 
+            grown[i] = (i < setCount[kind]) ? sets[kind][i] : nullptr;
+            delete[] sets[kind];
+            sets[kind] = grown;
+            setCount[kind] = newCount;
+        }
+        if (!sets[kind][key]) 
+        sets[kind][key] = new ParcelArrayList();
+        return sets[kind][key];
+    }
+    
+    void place(Parcel* p, int kind, int key) 
+    {
+        if (key < 0) 
+        return;
+        ParcelArrayList* set = setFor(kind, key);
+        p->indexKey[kind] = key;
+        p->indexSlot[kind] = set->size();
+        set->add(p);
+    }
+    
+    void unplace(Parcel* p, int kind) 
+    {
+        int key = p->indexKey[kind];
+        if (key < 0) 
+        return;
+        ParcelArrayList* set = sets[kind][key];
+        int slot = p->indexSlot[kind];
+        Parcel* last = set->get(set->size() - 1);
+        set->removeAt(slot);
+        if (last != p) 
+        last->indexSlot[kind] = slot;
+        p->indexKey[kind] = p->indexSlot[kind] = -1;
+    }
+
+public:
+    ParcelIndexes() 
+    {
+        for (int k = 0; k < INDEX_KINDS; k++) 
+        {
+            sets[k] = nullptr;
+            setCount[k] = 0;
+        }
+    }
+    
+    ~ParcelIndexes() 
+    {
+        for (int k = 0; k < INDEX_KINDS; k++) 
+        {
+            for (int i = 0; i < setCount[k]; i++) 
+            delete sets[k][i];
+            delete[] sets[k];
+        }
+    }
+    
+    void add(Parcel* p) 
+    {
+        p->indexes = this;
+        for (int k = 0; k < INDEX_KINDS; k++) 
+        place(p, k, keyOf(p, k));
+    }
+    
+    void remove(Parcel* p) 
+    {
+        for (int k = 0; k < INDEX_KINDS; k++) 
+        unplace(p, k);
+        p->indexes = nullptr;
+    }
+    
+    // Re-file the parcel after its key for 'kind' changed
+    void refresh(Parcel* p, int kind) 
+    {
+        int key = keyOf(p, kind);
+        if (key == p->indexKey[kind]) 
+        return;
+        unplace(p, kind);
+        place(p, kind, key);
+    }
+    
+    // Parcels with the given key (nullptr if none ever had it). The set changes as parcels
+    // move, so copy it before updating the parcels it holds.
+    const ParcelArrayList* find(int kind, int key) const 
+    {
+        return (key >= 0 && key < setCount[kind]) ? sets[kind][key] : nullptr;
+    }
+    
+    const ParcelArrayList* withStatus(int status) const 
+    {
+        return find(INDEX_STATUS, status);
+    }
+    
+    const ParcelArrayList* ofRider(int riderId) const 
+    {
+        return find(INDEX_RIDER, riderId);
+    }
+    
+    const ParcelArrayList* toDestination(const string& city) const 
+    {
+        return find(INDEX_DESTINATION, destinations.find(city));
+    }
+    
+    const ParcelArrayList* inZone(const string& zone) const 
+    {
+        return find(INDEX_ZONE, zones.find(zone));
+    }
+};
+
+void Parcel::updateStatus(int newStatus, string desc, string loc) 
+{
+    status = newStatus;
+    history->addEvent(desc, loc);
+    lastUpdateTime = time(0);
+    if (indexes) indexes->refresh(this, INDEX_STATUS);
+}
+
+void Parcel::assignRider(const string& name, int riderId) 
+{
+    assignedRider = name;
+    assignedRiderId = riderId;
+    if (indexes) indexes->refresh(this, INDEX_RIDER);
+}
+
+// Parcel database: Swiss-table layout. Each slot has one control byte: 0 when empty, 1 for a
+// tombstone, or 0x80 plus 7 bits of the key's hash when full. A probe loads a whole group of
+// control bytes at once and compares them against the hash byte (SSE2 / AVX2 compare-and-mask
+// when the compiler targets it, otherwise a byte loop), so an entry - and its string key - is
+// only touched on a control-byte hit. Groups are visited in triangular order, which covers
+// every group. Erasing leaves a tombstone so later probe chains stay intact. Once live entries
+// plus tombstones pass the load factor, entries move to a fresh table a few slots per insert
+// or erase (incremental rehash), so no single call pays for copying the whole table; lookups
+// check both tables until the move is done. The control bytes start as zero pages, so
+// allocating even a large table is cheap.
+// IDs are interned: each stored ID gets a dense 32-bit handle at insertion, its string is kept
+// once in a handle-indexed array beside the parcel pointer, and a slot holds only the handle
+// and the full hash (8 bytes). Internal code keeps handles (the undo log, for one) and turns
+// them back into parcels with get(), an array index; only IDs that come from outside are
+// hashed. The handle records live in fixed-size chunks, so issuing handles never copies
+// earlier ones. An erased ID's record goes on a free list and is reused by the next new ID,
+// so the records track live IDs rather than every ID ever seen. A handle carries the record's
+// generation in its top bits and erasing bumps it, so a handle to an erased parcel stays dead
+// instead of aliasing whatever parcel reuses the record; a record that runs out of
+// generations is retired for good.
+const unsigned char HASH_EMPTY = 0;
+const unsigned char HASH_TOMBSTONE = 1;
+const unsigned char HASH_FULL = 0x80;   // High bit of a full slot's control byte
+const int HASH_REHASH_STEP = 64;        // Old slots moved per insert / erase while resizing
+const int HANDLE_CHUNK_BITS = 12;       // Interned IDs are stored in chunks of 4096 handles
+const int HANDLE_CHUNK = 1 << HANDLE_CHUNK_BITS;
+const int HANDLE_INDEX_BITS = 24;       // Handle = generation << 24 | record index: 16M live IDs
+const ParcelHandle HANDLE_INDEX_MASK = (1u << HANDLE_INDEX_BITS) - 1;
+const unsigned int HANDLE_LAST_GENERATION = 254;   // Generation 255 is left to NO_PARCEL
+#ifdef __AVX2__
+const int HASH_GROUP = 32;              // Control bytes compared per probe step
+#else
+const int HASH_GROUP = 16;
+#endif
+
+// Index of the lowest set bit of a non-zero word
+inline int lowestBit(unsigned int x) 
+{
+#if defined(_MSC_VER)
+    unsigned long idx;
+    _BitScanForward(&idx, x);
+    return (int)idx;
+#else
+    return __builtin_ctz(x);
+#endif
+}
+
+// Bit i set where group byte i equals b
+inline unsigned int groupMatch(const unsigned char* group, unsigned char b) 
+{
+#if defined(__AVX2__)
+    __m256i ctrl = _mm256_loadu_si256((const __m256i*)group);
+    return (unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(ctrl, _mm256_set1_epi8((char)b)));
+#elif defined(HAS_SSE2)
+    __m128i ctrl = _mm_loadu_si128((const __m128i*)group);
+    return (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8((char)b)));
+#else
+    unsigned int mask = 0;
+    for (int i = 0; i < HASH_GROUP; i++) 
+    if (group[i] == b) mask |= 1u << i;
+    return mask;
+#endif
+}
+
+// Bit i set where group byte i is empty or a tombstone (high bit clear)
+inline unsigned int groupFree(const unsigned char* group) 
+{
+#if defined(__AVX2__)
+    return ~(unsigned int)_mm256_movemask_epi8(_mm256_loadu_si256((const __m256i*)group));
+#elif defined(HAS_SSE2)
+    return ~(unsigned int)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)group)) & 0xFFFFu;
+#else
+    unsigned int mask = 0;
+    for (int i = 0; i < HASH_GROUP; i++) 
+    if (!(group[i] & HASH_FULL)) mask |= 1u << i;
+    return mask;
+#endif
+}
+
+struct HashEntry 
+{ 
+    ParcelHandle handle;    // Interned ID
+    unsigned int hash;      // Full hash of the ID, kept so moves never rehash the string
+};
+
+struct HandleRecord 
+{
+    string id;              // "" once erased
+    Parcel* parcel;         // nullptr once erased
+    unsigned int generation;    // Bumped on every erase, so older handles stop matching
+    
+    HandleRecord() : parcel(nullptr), generation(0) {}
+};
+
+class ParcelHashTable 
+{
+private:
+    struct Slots 
+    {
+        HashEntry* entries;     // Raw storage: an entry is meaningful only while its slot is full
+        unsigned char* ctrl;    // Control byte per slot
+        int capacity;           // Power of two, at least two groups
+        
+        Slots() : entries(nullptr), ctrl(nullptr), capacity(0) {}
+        
+        void allocate(int cap) 
+        {
+            capacity = cap;
+            entries = static_cast<HashEntry*>(::operator new(sizeof(HashEntry) * (size_t)cap));
+            ctrl = static_cast<unsigned char*>(calloc(cap, 1)); // Fresh zero pages: all empty
+        }
+        
+        void release() 
+        {
+            ::operator delete(entries);
+            free(ctrl);
+            entries = nullptr; 
+            ctrl = nullptr; 
+            capacity = 0;
+        }
+        
+        // Slot of 'key' (records of stored handles in 'chunks'), or -1
+        int find(const string& key, unsigned int hash, HandleRecord* const* chunks) const 
+        {
+            unsigned char tag = (unsigned char)(HASH_FULL | (hash >> 25));
+            int groupMask = capacity / HASH_GROUP - 1;
+            int g = (int)(hash & groupMask);
+            for (int i = 1; i <= groupMask + 1; i++) 
+            {
+                const unsigned char* group = ctrl + g * HASH_GROUP;
+                for (unsigned int hits = groupMatch(group, tag); hits; hits &= hits - 1) 
+                {
+                    int slot = g * HASH_GROUP + lowestBit(hits);
+                    int r = (int)(entries[slot].handle & HANDLE_INDEX_MASK);
+                    if (entries[slot].hash == hash && chunks[r >> HANDLE_CHUNK_BITS][r & (HANDLE_CHUNK - 1)].id == key) 
+                    return slot;
+                }
+                if (groupMatch(group, HASH_EMPTY)) 
+                return -1;
+                g = (g + i) & groupMask;
+            }
+            return -1;
+        }
+    };
+    
+    Slots table;
+    int live;               // Entries in 'table'
+    int used;               // Live entries + tombstones in 'table'
+    Slots old;              // Table being drained by a resize (no storage otherwise)
+    int oldLive;
+    int migrated;           // Slots of 'old' already moved
+    double maxLoad;
+    ParcelIndexes* indexes; // Secondary indexes (nullptr for a bare table)
+    
+    HandleRecord** chunks;  // Record i: chunks[i / HANDLE_CHUNK][i % HANDLE_CHUNK]
+    int chunkCount;
+    int chunkCapacity;
+    int recordCount;        // Records handed out so far (live or free)
+    IntArrayList freeRecords;   // Records of erased IDs, ready for reuse
+    
+    // djb2, then a murmur3 finalizer so both the group index (low bits) and the control tag
+    // (top 7 bits) are well mixed even for IDs that differ only in their last character
+    static unsigned int hashFunction(const string& key) 
+    {
+        unsigned int hash = 5381;
+        for (char c : key) hash = ((hash << 5) + hash) + c; 
+        hash ^= hash >> 16; 
+        hash *= 0x85EBCA6Bu;
+        hash ^= hash >> 13; 
+        hash *= 0xC2B2AE35u;
+        hash ^= hash >> 16;
+        return hash;
+    }
+    
+    // Slot of 'key' in 'table' or, while resizing, in 'old' (-1 if absent); 'owner' is set to the table holding it
+    int locate(const string& key, unsigned int hash, Slots*& owner) 
+    {
+        owner = &table;
+        int slot = table.find(key, hash, chunks);
+        if (slot == -1 && old.ctrl) 
+        {
+            owner = &old;
+            slot = old.find(key, hash, chunks);
+        }
+        return slot;
+    }
+    
+    HandleRecord& record(ParcelHandle h) const 
+    {
+        int i = (int)(h & HANDLE_INDEX_MASK);
+        return chunks[i >> HANDLE_CHUNK_BITS][i & (HANDLE_CHUNK - 1)];
+    }
+    
+    // Handle for a new ID: on a free record if there is one, otherwise on a fresh one.
+    // NO_PARCEL if all 16M records hold live IDs.
+    ParcelHandle newHandle(const string& key, Parcel* value) 
+    {
+        int i;
+        if (!freeRecords.isEmpty()) 
+        {
+            i = freeRecords.get(freeRecords.size() - 1);
+            freeRecords.removeLast();
+        }
+        else if (recordCount > (int)HANDLE_INDEX_MASK) 
+        return NO_PARCEL;
+        else 
+        i = recordCount++;
+        
+        if (i == chunkCount * HANDLE_CHUNK) 
+        {
+            if (chunkCount == chunkCapacity) 
+            {
+                chunkCapacity = chunkCapacity ? chunkCapacity * 2 : 8;
+                HandleRecord** grown = new HandleRecord*[chunkCapacity];
+                for (int i = 0; i < chunkCount; i++) 
+                grown[i] = chunks[i];
+                delete[] chunks;
+                chunks = grown;
+            }
+            chunks[chunkCount++] = new HandleRecord[HANDLE_CHUNK];
+        }
+        ParcelHandle h = ((ParcelHandle)record((ParcelHandle)i).generation << HANDLE_INDEX_BITS) | (ParcelHandle)i;
+        HandleRecord& r = record(h);
+        r.id = key;
+        r.parcel = value;
+        return h;
+    }
+    
+    // Store a handle whose ID is known to be absent, reusing the first tombstone on its probe chain
+    void place(ParcelHandle handle, unsigned int hash) 
+    {
+        int groupMask = table.capacity / HASH_GROUP - 1;
+        int g = (int)(hash & groupMask);
+        unsigned int avail;
+        for (int i = 1; !(avail = groupFree(table.ctrl + g * HASH_GROUP)); i++) 
+        g = (g + i) & groupMask;
+        
+        int slot = g * HASH_GROUP + lowestBit(avail);
+        if (table.ctrl[slot] == HASH_EMPTY) used++;
+        table.entries[slot].handle = handle;
+        table.entries[slot].hash = hash;
+        table.ctrl[slot] = (unsigned char)(HASH_FULL | (hash >> 25));
+        live++;
+    }
+    
+    void migrateSome(int slots) 
+    {
+        while (old.ctrl && slots-- > 0 && migrated < old.capacity) 
+        {
+            int i = migrated++;
+            if (!(old.ctrl[i] & HASH_FULL)) 
+            continue;
+            place(old.entries[i].handle, old.entries[i].hash);
+            old.ctrl[i] = HASH_TOMBSTONE;
+            oldLive--;
+        }
+        if (old.ctrl && migrated == old.capacity) 
+        old.release();
+    }
+    
+    // Begin moving to a new table: twice the size if live entries need it, otherwise the
+    // same size (the move just sweeps out tombstones)
+    void startResize() 
+    {
+        migrateSome(INT_MAX); // Finish any earlier move first
+        int newCapacity = table.capacity;
+        if (live + 1 > table.capacity * maxLoad / 2) 
+        newCapacity = table.capacity * 2;
+        
+        old = table;
+        oldLive = live; 
+        migrated = 0;
+        table.allocate(newCapacity);
+        live = 0; 
+        used = 0;
+    }
+    
+    // Slots of both tables while a resize runs, for whole-table walks: i in [0, slotCount())
+    int slotCount() const 
+    {
+        return table.capacity + old.capacity;
+    }
+    
+    Parcel* slotValue(int i) const 
+    {
+        const Slots& t = (i < table.capacity) ? table : old;
+        if (i >= table.capacity) i -= table.capacity;
+        return (t.ctrl[i] & HASH_FULL) ? record(t.entries[i].handle).parcel : nullptr;
+    }
+    
+    // Appends every stored parcel to 'out': grouped by status when indexed, in slot order
+    // otherwise. A parcel with an out-of-range status (e.g. from a hand-edited save file) sits in
+    // no status set; if the sets come up short, the slots are walked so nobody is left out.
+    void collectAll(ParcelArrayList& out) const 
+    {
+        int start = out.size();
+        if (indexes) 
+        {
+            for (int s = 0; s < STATUS_COUNT; s++) 
+            collectStatus(s, out);
+            if (out.size() - start == size()) 
+            return;
+            while (out.size() > start) out.removeLast();
+        }
+        for (int i = 0; i < slotCount(); i++) 
+        if (slotValue(i)) out.add(slotValue(i));
+    }
+    
+    void collectStatus(int status, ParcelArrayList& out) const 
+    {
+        if (!indexes) 
+        {
+            for (int i = 0; i < slotCount(); i++) 
+            if (slotValue(i) && slotValue(i)->status == status) out.add(slotValue(i));
+            return;
+        }
+        const ParcelArrayList* set = indexes->withStatus(status);
+        for (int i = 0; set && i < set->size(); i++) 
+        out.add(set->get(i));
+    }
+
+public:
+    
+    // A bare table (withIndexes = false) may store one parcel under many keys, as the benchmarks do
+    ParcelHashTable(int cap = 1024, double loadFactor = 0.7, bool withIndexes = true) : live(0), used(0), oldLive(0), 
+                                                                                        migrated(0), maxLoad(0.7), indexes(nullptr), 
+                                                                                        chunks(nullptr), chunkCount(0), chunkCapacity(0), 
+                                                                                        recordCount(0) 
+    { 
+        int size = 2 * HASH_GROUP;
+        while (size < cap) size *= 2;
+        table.allocate(size);
+        setMaxLoad(loadFactor);
+        if (withIndexes) indexes = new ParcelIndexes();
+    }
+    
+    ~ParcelHashTable() 
+    {
+        table.release();
+        if (old.ctrl) old.release();
+        delete indexes;
+        for (int i = 0; i < chunkCount; i++) 
+        delete[] chunks[i];
+        delete[] chunks;
+    }
+    
+    // Resize threshold on (live + tombstones) / capacity, kept within [0.25, 0.9]
+    void setMaxLoad(double loadFactor) 
+    {
+        maxLoad = loadFactor < 0.25 ? 0.25 : (loadFactor > 0.9 ? 0.9 : loadFactor);
+    }
+    
+    int size() const 
+    {
+        return live + oldLive;
+    }
+    
+    int getCapacity() const 
+    {
+        return table.capacity;
+    }
+    
+    bool isResizing() const 
+    {
+        return old.ctrl != nullptr;
+    }
+    
+    // Interns the ID and stores the parcel under it (replacing the parcel of a known ID).
+    // Returns the ID's handle, which is also recorded in the parcel, or NO_PARCEL (nothing
+    // stored) if the table already holds the maximum of 16M IDs.
+    ParcelHandle insert(const string& key, Parcel* value) 
+    {
+        unsigned int hash = hashFunction(key);
+        Slots* owner;
+        int slot = locate(key, hash, owner);
+        if (slot != -1) 
+        { 
+            ParcelHandle h = owner->entries[slot].handle;
+            HandleRecord& r = record(h);
+            if (indexes && r.parcel != value) 
+            {
+                indexes->remove(r.parcel);
+                indexes->add(value);
+            }
+            r.parcel = value; 
+            value->handle = h;
+            return h; 
+        }
+        
+        ParcelHandle h = newHandle(key, value);
+        if (h == NO_PARCEL) 
+        return NO_PARCEL;
+        if (used + 1 > table.capacity * maxLoad) 
+        startResize();
+        place(h, hash);
+        value->handle = h;
+        if (indexes) indexes->add(value);
+        migrateSome(HASH_REHASH_STEP);
+        return h;
+    }
+    
+    // Returns false if the key was not present. The ID's handle goes dead; its record is
+    // reused by a later ID under a new generation.
+    bool erase(const string& key) 
+    {
+        unsigned int hash = hashFunction(key);
+        Slots* owner;
+        int slot = locate(key, hash, owner);
+        if (slot != -1) 
+        {
+            ParcelHandle h = owner->entries[slot].handle;
+            HandleRecord& r = record(h);
+            owner->ctrl[slot] = HASH_TOMBSTONE;
+            if (owner == &table) live--; 
+            else oldLive--;
+            if (indexes) indexes->remove(r.parcel);
+            r.parcel = nullptr;
+            r.id.clear();
+            if (++r.generation <= HANDLE_LAST_GENERATION) 
+            freeRecords.add((int)(h & HANDLE_INDEX_MASK));
+        }
+        migrateSome(HASH_REHASH_STEP);
+        return slot != -1;
+    }
+    
+    // Lookup by an external ID (hashes the string)
+    Parcel* search(const string& key) 
+    {
+        Slots* owner;
+        int slot = locate(key, hashFunction(key), owner);
+        return slot != -1 ? record(owner->entries[slot].handle).parcel : nullptr;
+    }
+    
+    // Lookup by handle: a plain array index. nullptr once the parcel was erased.
+    Parcel* get(ParcelHandle h) const 
+    {
+        if (h == NO_PARCEL || (int)(h & HANDLE_INDEX_MASK) >= recordCount) 
         return nullptr;
+        const HandleRecord& r = record(h);
+        return (r.generation == (h >> HANDLE_INDEX_BITS)) ? r.parcel : nullptr;
+    }
+    
+    // Handle records in use or waiting on the free list (at most the peak number of live IDs)
+    int getRecordCount() const 
+    {
+        return recordCount;
+    }
+    
+    // Appends every parcel assigned to the rider (RiderPool ID) to 'out'
+    void collectRider(int riderId, ParcelArrayList& out) const 
+    {
+        if (!indexes) 
+        {
+            for (int i = 0; i < slotCount(); i++) 
+            if (slotValue(i) && slotValue(i)->assignedRiderId == riderId) out.add(slotValue(i));
+            return;
+        }
+        const ParcelArrayList* set = indexes->ofRider(riderId);
+        for (int i = 0; set && i < set->size(); i++) 
+        out.add(set->get(i));
     }
+    
+    // Appends every parcel bound for the city to 'out'
+    void collectDestination(const string& city, ParcelArrayList& out) const 
+    {
+        if (!indexes) 
+        {
+            for (int i = 0; i < slotCount(); i++) 
+            if (slotValue(i) && slotValue(i)->destination == city) out.add(slotValue(i));
+            return;
+        }
+        const ParcelArrayList* set = indexes->toDestination(city);
+        for (int i = 0; set && i < set->size(); i++) 
+        out.add(set->get(i));
+    }
+    
+    // Appends every parcel of the destination zone to 'out'
+    void collectZone(const string& zone, ParcelArrayList& out) const 
+    {
+        if (!indexes) 
+        {
+            for (int i = 0; i < slotCount(); i++) 
+            if (slotValue(i) && slotValue(i)->zone == zone) out.add(slotValue(i));
+            return;
+        }
+        const ParcelArrayList* set = indexes->inZone(zone);
+        for (int i = 0; set && i < set->size(); i++) 
+        out.add(set->get(i));
+    }
+    
     void printAll() 
+    {
+        ParcelArrayList all;
+        collectAll(all);
+        printList(all);
+    }
+    
+    // Database listing of the given parcels (e.g. one destination's or zone's)
+    void printList(const ParcelArrayList& list) 
     {
         clearScreen();
         cout << "\n=========================================\n           SYSTEM DATABASE\n=========================================\n";
         cout << "ID     DEST         CAT     ZONE     STATUS\n";
-        for(int i=0; i<capacity; i++) 
-        if(table[i].occupied) 
-        cout << *table[i].value << endl;
+        for(int i=0; i<list.size(); i++) 
+        cout << *list.get(i) << endl;
+        if (list.isEmpty()) cout << "(No matching parcels)\n";
         cout << "-----------------------------------------\n";
     }
 
     void saveToFile(ofstream& out) 
     {
-        for(int i=0; i<capacity; i++) if(table[i].occupied) 
+        ParcelArrayList all;
+        collectAll(all);
+        for(int i=0; i<all.size(); i++) 
         {
-            Parcel* p = table[i].value;
+            Parcel* p = all.get(i);
             out << p->id << "," << p->destination << "," << p->weight << "," << p->priority << "," << p->status << "," << p->zone << endl;
         }
     }
 
     void exportJSON(ofstream& out)
     {
-        bool first = true;
-        for(int i=0; i<capacity; i++)
+        ParcelArrayList all;
+        collectAll(all);
+        for(int i=0; i<all.size(); i++)
         {
-            if(table[i].occupied)
-            {
-                if(!first) out << ",\n";
-                Parcel* p = table[i].value;
-                out << "    { \"id\": \"" << p->id << "\", \"status\": \"" << p->getStatusString() 
-                    << "\", \"status_code\": " << p->status << ", \"destination\": \"" << p->destination 
-                    << "\", \"zone\": \"" << p->zone << "\", \"rider\": \"" << (p->assignedRider.empty() ? "None" : p->assignedRider) << "\" }";
-                first = false;
-            }
+            if(i > 0) out << ",\n";
+            Parcel* p = all.get(i);
+            out << "    { \"id\": \"" << p->id << "\", \"status\": \"" << p->getStatusString() 
+                << "\", \"status_code\": " << p->status << ", \"destination\": \"" << p->destination 
+                << "\", \"zone\": \"" << p->zone << "\", \"rider\": \"" << (p->assignedRider.empty() ? "None" : p->assignedRider) << "\" }";
         }
     }
     
     void runInvestigationProtocol() 
     {
+        // Copied out first: resolving a case moves the parcel out of the status set
+        ParcelArrayList cases;
+        collectStatus(STATUS_UNDER_INVESTIGATION, cases);
         int resolved = 0;
-        for(int i=0; i<capacity; i++) 
+        for(int i=0; i<cases.size(); i++) 
         {
-            if(table[i].occupied && table[i].value->status == 9) // STATUS_UNDER_INVESTIGATION
+            Parcel* p = cases.get(i);
+            resolved++;
+            
+            cout << "   [CASE #" << p->id << "] Investigating...";
+            
+            // 30% Recovery Chance
+            int roll = rand() % 100;
+            if(roll < 30) 
             {
-                Parcel* p = table[i].value;
-                resolved++;
-                
-                cout << "   [CASE #" << p->id << "] Investigating...";
+                setColor(COLOR_GREEN); cout << " FOUND!\n"; resetColor();
+                p->updateStatus(1, "Parcel Recovered - Returned to Warehouse", "Warehouse"); // STATUS_WAREHOUSE
+                cout << "     >> Parcel Restored to Active Duty.\n";
+            }
+            else 
+            {
+                setColor(COLOR_RED); cout << " CONFIRMED LOST.\n"; resetColor();
+                p->updateStatus(7, "Investigation Concluded - DECLARED LOST", "Unknown"); // STATUS_MISSING
                 
-                // 30% Recovery Chance
-                int roll = rand() % 100;
-                if(roll < 30) 
-                {
-                    setColor(COLOR_GREEN); cout << " FOUND!\n"; resetColor();
-                    p->updateStatus(1, "Parcel Recovered - Returned to Warehouse", "Warehouse"); // STATUS_WAREHOUSE
-                    cout << "     >> Parcel Restored to Active Duty.\n";
-                }
-                else 
-                {
-                    setColor(COLOR_RED); cout << " CONFIRMED LOST.\n"; resetColor();
-                    p->updateStatus(7, "Investigation Concluded - DECLARED LOST", "Unknown"); // STATUS_MISSING
-                    
-                    // Refund Calculation
-                    double refund = (150.0 + (p->weight * 20.0)) * 1.5; // Base + Weight * 1.5 Insurance
-                    cout << "     >> Generating Insurance Claim...\n";
-                    setColor(COLOR_YELLOW);
-                    cout << "     >> COMPENSATION VOUCHER GENERATED: Rs. " << (int)refund << ".00\n";
-                    resetColor();
-                }
-                cout << "\n";
+                // Refund Calculation
+                double refund = (150.0 + (p->weight * 20.0)) * 1.5; // Base + Weight * 1.5 Insurance
+                cout << "     >> Generating Insurance Claim...\n";
+                setColor(COLOR_YELLOW);
+                cout << "     >> COMPENSATION VOUCHER GENERATED: Rs. " << (int)refund << ".00\n";
+                resetColor();
             }
+            cout << "\n";
         }
         
         if(resolved == 0) cout << "   >> No pending investigations found.\n";
@@ -871,8 +2216,9 @@ struct Edge
     int dest;
     int weight;
     bool isBlocked;
+    unsigned char profile;  // Traffic profile id (TRAFFIC_*)
     
-    Edge(int d=0, int w=0) : dest(d), weight(w), isBlocked(false) {}
+    Edge(int d=0, int w=0, int prof=0) : dest(d), weight(w), isBlocked(false), profile((unsigned char)prof) {}
 };
 
 
@@ -974,359 +2320,3560 @@ struct CityNode
     CityNode(string n="", string z="") : name(n), zone(z) {} 
 };
 
-class MapGraph 
+// Hash index keyed on a packed 64-bit (u,v) city pair, mapping to an int slot.
+// Open addressing with linear probing over a power-of-two table, grows at half load.
+struct PairEntry 
+{ 
+    unsigned long long key; 
+    int value; 
+    bool occupied; 
+    PairEntry() : key(0), value(-1), occupied(false) {} 
+};
+
+class PairIndex 
 {
-public:
-    CityNode* cities; int cityCount; int cityCapacity;
+private:
+    PairEntry* table; 
+    int capacity; 
+    int count;
     
-    // Store found paths for user selection (Max 5 paths)
-    IntArrayList availablePaths[5]; 
-    int availablePathDistances[5];
-    int pathCount;
-
-    MapGraph() : cityCount(0), cityCapacity(15) 
-    { 
-        cities = new CityNode[cityCapacity]; 
+    static unsigned long long mix(unsigned long long x) 
+    {
+        // SplitMix64 finalizer: spreads neighbouring ids across the table
+        x ^= x >> 30; x *= 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 27; x *= 0x94d049bb133111ebULL;
+        x ^= x >> 31;
+        return x;
     }
     
-    // Destructor to prevent memory leak
-    ~MapGraph() 
+    int findSlot(unsigned long long key) const 
     {
-        delete[] cities;
+        int mask = capacity - 1;
+        int probe = (int)(mix(key) & mask);
+        while (table[probe].occupied && table[probe].key != key) 
+        probe = (probe + 1) & mask;
+        return probe;
     }
-
     
-    int addCity(string name, string zone) 
+    void rehash(int newCapacity) 
+    {
+        PairEntry* old = table; 
+        int oldCapacity = capacity;
+        table = new PairEntry[newCapacity]; 
+        capacity = newCapacity;
+        for (int i = 0; i < oldCapacity; i++) 
+        {
+            if (old[i].occupied) 
+            table[findSlot(old[i].key)] = old[i];
+        }
+        delete[] old;
+    }
+
+public:
+    PairIndex(int cap = 64) : capacity(cap), count(0) 
     { 
-        if (cityCount == cityCapacity) 
-        return -1; 
-        cities[cityCount] = CityNode(name, zone); 
-        return cityCount++; 
+        table = new PairEntry[capacity]; 
     }
     
-    void addRoad(int u, int v, int dist) 
+    ~PairIndex() 
     { 
-        cities[u].edges.add(Edge(v, dist)); 
-        cities[v].edges.add(Edge(u, dist)); 
+        delete[] table; 
     }
     
-    int getCityIndex(string name) 
+    static unsigned long long pack(int u, int v) 
     { 
-        for(int i=0; i<cityCount; i++) 
-        if (cities[i].name == name) 
-        return i; 
+        return ((unsigned long long)(unsigned int)u << 32) | (unsigned int)v; 
+    }
+    
+    // Insert or overwrite
+    void put(int u, int v, int value) 
+    {
+        if ((count + 1) * 2 > capacity) 
+        rehash(capacity * 2);
         
-        return -1; 
+        unsigned long long key = pack(u, v);
+        int slot = findSlot(key);
+        if (!table[slot].occupied) 
+        count++;
+        table[slot].key = key; 
+        table[slot].value = value; 
+        table[slot].occupied = true;
     }
     
-    string getZone(string name) 
+    // Returns -1 if the pair is not present
+    int get(int u, int v) const 
     {
-        int idx = getCityIndex(name);
-        if(idx != -1) 
-        return cities[idx].zone;
+        int slot = findSlot(pack(u, v));
+        return table[slot].occupied ? table[slot].value : -1;
+    }
+    
+    void clear() 
+    {
+        for (int i = 0; i < capacity; i++) 
+        table[i].occupied = false;
+        count = 0;
+    }
+    
+    int size() const 
+    { 
+        return count; 
+    }
+};
 
-        return "Unknown";
+// Time-dependent traffic profiles.
+// A profile is a periodic piecewise-linear congestion curve over the day: breakpoints are
+// (minute of day, travel-time factor in per-mille), stored once in pooled unsigned short
+// arrays and shared by every road using it; an Edge only carries a one-byte profile id.
+// Free-flow speed is 60 km/h, so a road's base travel time in minutes equals its length.
+const int TRAFFIC_FREE_FLOW = 0;
+const int TRAFFIC_URBAN = 1;            // Sharp morning and evening commuter peaks
+const int TRAFFIC_HIGHWAY = 2;          // Mild daytime slowdown on intercity roads
+const int TRAFFIC_URBAN_MAX_KM = 150;   // Shorter roads get the urban profile
+const int MINUTES_PER_DAY = 1440;
+
+// Simulation clock: one real second advances the simulated day by this many minutes
+const int SIM_MINUTES_PER_SECOND = 30;
+
+class TrafficProfiles 
+{
+private:
+    static const int MAX_POINTS = 32;
+    
+    int count;
+    int offset[4];                      // count + 1 entries into the pooled arrays
+    unsigned short minute[MAX_POINTS];  // Breakpoint minute of day, last one is 1440
+    unsigned short factor[MAX_POINTS];  // Travel-time factor at the breakpoint, 1000 = free flow
+    int used;
+    
+    void addProfile(const unsigned short* m, const unsigned short* f, int n) 
+    {
+        offset[count] = used;
+        for (int i = 0; i < n; i++) 
+        {
+            minute[used] = m[i]; 
+            factor[used] = f[i];
+            used++;
+        }
+        offset[++count] = used;
+    }
+    
+    // Travel minutes when entering a road of 'baseMinutes' at minute of day 'tod' (rounded up)
+    int travelAt(int p, int baseMinutes, int tod) const 
+    {
+        int i = offset[p];
+        while (minute[i + 1] <= tod) 
+        i++;
+        int span = minute[i + 1] - minute[i];
+        long long f = (long long)factor[i] * span + ((long long)factor[i + 1] - factor[i]) * (tod - minute[i]);
+        long long scaled = (long long)baseMinutes * f;
+        long long denom = 1000LL * span;
+        return (int)((scaled + denom - 1) / denom);
     }
 
-    void blockRandomRoad() 
+public:
+    TrafficProfiles() : count(0), used(0) 
     {
-        if (cityCount < 2) 
-        return;
-        int u = rand() % cityCount;
-        if (cities[u].edges.size() > 0) 
+        static const unsigned short flatM[] = { 0, 1440 };
+        static const unsigned short flatF[] = { 1000, 1000 };
+        static const unsigned short urbanM[] = { 0, 360, 480, 600, 960, 1080, 1200, 1440 };
+        static const unsigned short urbanF[] = { 1000, 1000, 1900, 1200, 1200, 2000, 1100, 1000 };
+        static const unsigned short highwayM[] = { 0, 420, 540, 1020, 1140, 1320, 1440 };
+        static const unsigned short highwayF[] = { 1000, 1000, 1300, 1250, 1350, 1000, 1000 };
+        addProfile(flatM, flatF, 2);
+        addProfile(urbanM, urbanF, 8);
+        addProfile(highwayM, highwayF, 7);
+    }
+    
+    static int classify(int km) 
+    {
+        return km <= TRAFFIC_URBAN_MAX_KM ? TRAFFIC_URBAN : TRAFFIC_HIGHWAY;
+    }
+    
+    // Minutes from reaching a road at absolute simulated minute 'when' to leaving its far end.
+    // A driver may wait before entering if a peak is about to clear; that makes arrival times
+    // non-decreasing in departure time (FIFO), which TD-Dijkstra relies on. Between two
+    // breakpoints departure + travel is linear, so only the current minute and the upcoming
+    // breakpoints of the next day can be optimal.
+    int delay(int p, int baseMinutes, long long when) const 
+    {
+        if (p == TRAFFIC_FREE_FLOW) 
+        return baseMinutes;
+        
+        int tod = (int)(when % MINUTES_PER_DAY);
+        int best = travelAt(p, baseMinutes, tod);
+        for (int i = offset[p]; i < offset[p + 1] - 1; i++) 
         {
-            int eIdx = rand() % cities[u].edges.size();
-            cities[u].edges.getRef(eIdx).isBlocked = true;
-            cout << ">>> [ALERT] Road near " << cities[u].name << " is now BLOCKED!\n";
+            int wait = minute[i] - tod;
+            if (wait <= 0) wait += MINUTES_PER_DAY;
+            if (wait >= best) continue;
+            int total = wait + (int)(((long long)baseMinutes * factor[i] + 999) / 1000);
+            if (total < best) best = total;
         }
+        return best;
     }
+};
 
-    void displayNetwork() 
+TrafficProfiles& trafficProfiles() 
+{
+    static TrafficProfiles profiles;
+    return profiles;
+}
+
+long long simMinuteNow(long long realTime) 
+{
+    return realTime * SIM_MINUTES_PER_SECOND;
+}
+
+// Immutable Compressed Sparse Row (CSR) snapshot of the road network.
+// The roads of city u are arcs [offset[u], offset[u+1]) stored in contiguous arrays, in the
+// same order as cities[u].edges, so arc = offset[u] + edge index. Blocked flags are packed bits.
+class RoadNetworkCSR 
+{
+public:
+    int nodeCount; 
+    int arcCount;
+    int* offset;                // nodeCount + 1 entries
+    int* dest;                  // arcCount entries
+    int* weight;                // arcCount entries
+    unsigned char* profile;     // arcCount entries, traffic profile ids
+    unsigned int* blockedBits;  // (arcCount + 31) / 32 words
+    unsigned long builtEpoch;   // structure epoch the snapshot was taken at
+
+    RoadNetworkCSR() : nodeCount(0), arcCount(0), offset(nullptr), dest(nullptr), weight(nullptr), 
+                       profile(nullptr), blockedBits(nullptr), builtEpoch(0) {}
+    
+    ~RoadNetworkCSR() 
     {
-        clearScreen();
-        cout << "\n=========================================\n      LOGISTICS NETWORK MAP VIEW\n=========================================\n";
-        for(int i=0; i<cityCount; i++) 
+        release();
+    }
+    
+    void release() 
+    {
+        delete[] offset; delete[] dest; delete[] weight; delete[] profile; delete[] blockedBits;
+        offset = nullptr; dest = nullptr; weight = nullptr; profile = nullptr; blockedBits = nullptr;
+    }
+    
+    void build(CityNode* cities, int n) 
+    {
+        release();
+        nodeCount = n;
+        offset = new int[n + 1];
+        
+        arcCount = 0;
+        for (int u = 0; u < n; u++) 
         {
-            cout << " [" << cities[i].zone << "] " << left << setw(12) << cities[i].name << " connects to:\n";
-            EdgeArrayList& edges = cities[i].edges;
-            
-            for(int k=0; k<edges.size(); k++) 
+            offset[u] = arcCount;
+            arcCount += cities[u].edges.size();
+        }
+        offset[n] = arcCount;
+        
+        dest = new int[arcCount > 0 ? arcCount : 1];
+        weight = new int[arcCount > 0 ? arcCount : 1];
+        profile = new unsigned char[arcCount > 0 ? arcCount : 1];
+        int words = (arcCount + 31) / 32;
+        blockedBits = new unsigned int[words > 0 ? words : 1];
+        for (int w = 0; w < words; w++) 
+        blockedBits[w] = 0;
+        
+        for (int u = 0; u < n; u++) 
+        {
+            EdgeArrayList& edges = cities[u].edges;
+            for (int i = 0; i < edges.size(); i++) 
             {
-                Edge& e = edges.getRef(k);
-                cout << "    --> " << setw(12) << cities[e.dest].name << " | " << e.weight << "km";
-                if(e.isBlocked) cout << " [BLOCKED]";
-                cout << endl;
+                Edge& e = edges.getRef(i);
+                int a = offset[u] + i;
+                dest[a] = e.dest;
+                weight[a] = e.weight;
+                profile[a] = e.profile;
+                if (e.isBlocked) 
+                blockedBits[a >> 5] |= (1u << (a & 31));
             }
-            cout << "-----------------------------------------\n";
         }
     }
+    
+    int arcBegin(int u) const { return offset[u]; }
+    int arcEnd(int u) const { return offset[u + 1]; }
+    
+    bool isBlocked(int a) const 
+    { 
+        return (blockedBits[a >> 5] >> (a & 31)) & 1u; 
+    }
+    
+    void setBlocked(int a, bool blocked) 
+    {
+        if (blocked) blockedBits[a >> 5] |= (1u << (a & 31));
+        else blockedBits[a >> 5] &= ~(1u << (a & 31));
+    }
+};
 
-    void findAllPaths(int start, int end) 
+// Binary Min-Heap of (city, distance) pairs for Dijkstra.
+// Uses lazy deletion: a city may be pushed several times, stale entries are skipped on pop.
+struct HeapNode 
+{
+    int vertex;
+    int dist;
+};
+
+class MinDistHeap 
+{
+private:
+    HeapNode* data; 
+    int capacity; 
+    int count;
+    
+    void resize(int newCapacity) 
     {
-        bool* visited = new bool[cityCount];
-        for(int i=0; i<cityCount; i++) 
-        visited[i] = false;
-        pathCount = 0;
-        IntArrayList currentPath;
+        HeapNode* newData = new HeapNode[newCapacity];
+        for (int i = 0; i < count; i++) 
+        newData[i] = data[i];
+        delete[] data; 
+        data = newData; 
+        capacity = newCapacity;
+    }
+    
+    void swapNodes(int i, int j) 
+    {
+        HeapNode temp = data[i]; 
+        data[i] = data[j]; 
+        data[j] = temp;
+    }
+
+public:
+    MinDistHeap(int cap = 16) : capacity(cap), count(0) 
+    { 
+        data = new HeapNode[capacity]; 
+    }
+    
+    ~MinDistHeap() 
+    { 
+        delete[] data; 
+    }
+    
+    void push(int vertex, int dist) 
+    {
+        if (count == capacity) 
+        resize(capacity * 2);
         
-        solveDFS(start, end, visited, currentPath, 0);
+        int index = count++;
+        data[index].vertex = vertex; 
+        data[index].dist = dist;
         
-        delete[] visited;
+        while (index > 0) 
+        {
+            int parent = (index - 1) / 2;
+            if (data[index].dist < data[parent].dist) 
+            {
+                swapNodes(index, parent); index = parent;
+            } 
+            else 
+            break;
+        }
     }
-
-    void solveDFS(int u, int d, bool visited[], IntArrayList currentPath, int currentDist) 
+    
+    HeapNode pop() 
     {
-        visited[u] = true;
-        currentPath.add(u);
+        HeapNode top = data[0];
+        data[0] = data[--count];
         
-        if (u == d) 
+        int index = 0;
+        while (true) 
         {
-             if (pathCount < 5) 
-             {
-                availablePaths[pathCount] = currentPath; 
-                availablePathDistances[pathCount] = currentDist;
-                pathCount++;
-            }
-        } 
-        else 
+            int left = 2 * index + 1, right = 2 * index + 2, smallest = index;
+            if (left < count && data[left].dist < data[smallest].dist) 
+            smallest = left;
+            if (right < count && data[right].dist < data[smallest].dist) 
+            smallest = right;
+            if (smallest == index) 
+            break;
+            swapNodes(index, smallest); index = smallest;
+        }
+        return top;
+    }
+    
+    HeapNode peek() const 
+    { 
+        return data[0]; 
+    }
+    
+    bool isEmpty() const 
+    { 
+        return count == 0; 
+    }
+    
+    void clear() 
+    { 
+        count = 0; 
+    }
+};
+
+// Growable list of candidate routes (path + total distance) used by Yen's algorithm
+class PathList 
+{
+private:
+    IntArrayList* paths; 
+    int* dists; 
+    int capacity; 
+    int count;
+    
+    void resize(int newCapacity) 
+    {
+        IntArrayList* newPaths = new IntArrayList[newCapacity];
+        int* newDists = new int[newCapacity];
+        for (int i = 0; i < count; i++) 
+        { 
+            newPaths[i] = paths[i]; 
+            newDists[i] = dists[i]; 
+        }
+        delete[] paths; 
+        delete[] dists;
+        paths = newPaths; 
+        dists = newDists; 
+        capacity = newCapacity;
+    }
+
+public:
+    PathList() : capacity(8), count(0) 
+    { 
+        paths = new IntArrayList[capacity]; 
+        dists = new int[capacity]; 
+    }
+    
+    ~PathList() 
+    { 
+        delete[] paths; 
+        delete[] dists; 
+    }
+    
+    void add(const IntArrayList& path, int dist) 
+    {
+        if (count == capacity) 
+        resize(capacity * 2);
+        paths[count] = path; 
+        dists[count] = dist; 
+        count++;
+    }
+    
+    // Remove by moving the last entry into the hole (order is not preserved)
+    void removeAt(int index) 
+    {
+        if (index < 0 || index >= count) 
+        return;
+        count--;
+        paths[index] = paths[count]; 
+        dists[index] = dists[count];
+    }
+    
+    bool contains(const IntArrayList& path) const 
+    {
+        for (int i = 0; i < count; i++) 
+        if (samePath(paths[i], path)) 
+        return true;
+        return false;
+    }
+    
+    int minIndex() const 
+    {
+        int best = -1;
+        for (int i = 0; i < count; i++) 
+        if (best == -1 || dists[i] < dists[best]) 
+        best = i;
+        return best;
+    }
+    
+    IntArrayList& getPath(int index) { return paths[index]; }
+    int getDist(int index) const { return dists[index]; }
+    int size() const { return count; }
+    
+    static bool samePath(const IntArrayList& a, const IntArrayList& b) 
+    {
+        if (a.size() != b.size()) 
+        return false;
+        for (int i = 0; i < a.size(); i++) 
+        if (a.get(i) != b.get(i)) 
+        return false;
+        return true;
+    }
+};
+
+// Customizable Contraction Hierarchy (CCH) over the CSR road network.
+// build() contracts the network once in a metric-independent nested-dissection order, adding a
+// shortcut between every pair of higher-ranked neighbours. customize() then fills in arc
+// weights bottom-up over lower triangles, so a block/unblock only re-runs customize().
+// Queries search upward from both ends along the elimination tree and unpack shortcuts recursively.
+class ContractionHierarchy 
+{
+private:
+    static const int INF = INT_MAX / 2;
+    
+    int nodeCount;
+    int* rank;          // Contraction position of each city (higher = more important)
+    int* order;         // order[r] = city contracted at position r
+    
+    // Upward graph in CSR form: arcs from a city to its higher-ranked neighbours, sorted by id
+    int* upOffset;
+    int* upHead;
+    int* upTail;        // City each upward arc starts from
+    int* upWeight;      // Customized length (INF if unusable)
+    int* upMiddle;      // -1 = real road, otherwise the city the shortcut bypasses
+    int upArcCount;
+    
+    int* etreeParent;   // Lowest-ranked upward neighbour (elimination tree), -1 at a root
+    
+    // Query scratch (INF outside a query; reset along the ancestor chains)
+    int* distF; int* distB;
+    int* parentF; int* parentB;   // Arc used to reach the city (-1 at the roots)
+    
+    void release() 
+    {
+        delete[] rank; delete[] order;
+        delete[] upOffset; delete[] upHead; delete[] upTail; delete[] upWeight; delete[] upMiddle;
+        delete[] etreeParent; delete[] distF; delete[] distB; delete[] parentF; delete[] parentB;
+        etreeParent = nullptr;
+        rank = order = upOffset = upHead = upTail = upWeight = upMiddle = nullptr;
+        distF = distB = parentF = parentB = nullptr;
+    }
+    
+    // Upward arc from 'low' to 'high' (rank[low] < rank[high]), or -1
+    int findArc(int low, int high) const 
+    {
+        int lo = upOffset[low], hi = upOffset[low + 1] - 1;
+        while (lo <= hi) 
         {
-            EdgeArrayList& edges = cities[u].edges;
-            for(int i=0; i<edges.size(); i++) 
+            int mid = (lo + hi) / 2;
+            if (upHead[mid] == high) return mid;
+            if (upHead[mid] < high) lo = mid + 1;
+            else hi = mid - 1;
+        }
+        return -1;
+    }
+    
+    int arcBetween(int u, int v) const 
+    {
+        return (rank[u] < rank[v]) ? findArc(u, v) : findArc(v, u);
+    }
+    
+    // Append the real cities of arc (from -> to) to 'path', excluding 'from'
+    void unpack(int from, int to, IntArrayList& path) const 
+    {
+        int mid = upMiddle[arcBetween(from, to)];
+        if (mid == -1) 
+        {
+            path.add(to);
+            return;
+        }
+        unpack(from, mid, path);
+        unpack(mid, to, path);
+    }
+    
+    // Relax the upward arcs of a city whose label is final
+    void relaxUp(int u, int* dist, int* parent) 
+    {
+        if (dist[u] >= INF) 
+        return;
+        for (int a = upOffset[u]; a < upOffset[u + 1]; a++) 
+        {
+            if (upWeight[a] >= INF) 
+            continue;
+            int v = upHead[a];
+            int nd = dist[u] + upWeight[a];
+            if (nd < dist[v]) 
             {
-                Edge& e = edges.getRef(i);
-                if(!visited[e.dest] && !e.isBlocked) 
-                {
-                    solveDFS(e.dest, d, visited, currentPath, currentDist + e.weight);
-                }
+                dist[v] = nd;
+                parent[v] = a;
             }
         }
-        visited[u] = false;
     }
     
-    int getMinRouteIndex() 
+    // Nested dissection: split 'nodes' with a BFS-level separator, rank the separator above
+    // both halves and recurse. Small separators keep the number of fill-in shortcuts low.
+    // Ranks are handed out from 'top' downwards.
+    void dissect(const RoadNetworkCSR& g, const IntArrayList& nodes, int stamp, int* mark, int* level, int& nextStamp, int& top) 
     {
-        int minIdx = -1;
-        int minDist = INT_MAX;
-        for(int i=0; i<pathCount; i++) 
+        const int LEAF_SIZE = 16;
+        if (nodes.size() <= LEAF_SIZE) 
         {
-            if(availablePathDistances[i] < minDist) 
+            for (int i = 0; i < nodes.size(); i++) 
             {
-                minDist = availablePathDistances[i];
-                minIdx = i;
+                int v = nodes.get(i);
+                rank[v] = top; 
+                order[top] = v; 
+                top--;
+                mark[v] = -1;
             }
+            return;
         }
-        return minIdx;
-    }
+        
+        // Split into connected components first
+        IntArrayList queue;
+        int firstStamp = nextStamp;
+        for (int i = 0; i < nodes.size(); i++) 
+        {
+            int root = nodes.get(i);
+            if (mark[root] != stamp) 
+            continue;
+            int comp = nextStamp++;
+            mark[root] = comp; 
+            queue.clear(); 
+            queue.add(root);
+            for (int h = 0; h < queue.size(); h++) 
+            {
+                int u = queue.get(h);
+                for (int a = g.arcBegin(u); a < g.arcEnd(u); a++) 
+                {
+                    int v = g.dest[a];
+                    if (mark[v] == stamp) 
+                    { 
+                        mark[v] = comp; 
+                        queue.add(v); 
+                    }
+                }
+            }
+            if (queue.size() == nodes.size()) 
+            break; // Connected: 'queue' now holds the whole component
+        }
+        
+        if (nextStamp - firstStamp > 1) 
+        {
+            IntArrayList part;
+            for (int c = firstStamp; c < nextStamp; c++) 
+            {
+                part.clear();
+                for (int i = 0; i < nodes.size(); i++) 
+                if (mark[nodes.get(i)] == c) 
+                part.add(nodes.get(i));
+                dissect(g, part, c, mark, level, nextStamp, top);
+            }
+            return;
+        }
+        stamp = firstStamp;
+        
+        // BFS from the last city reached (a pseudo-peripheral city) to get level sets
+        int root = queue.get(queue.size() - 1);
+        for (int i = 0; i < nodes.size(); i++) 
+        level[nodes.get(i)] = -1;
+        level[root] = 0;
+        queue.clear(); 
+        queue.add(root);
+        IntArrayList levelSize;
+        levelSize.add(1);
+        for (int h = 0; h < queue.size(); h++) 
+        {
+            int u = queue.get(h);
+            for (int a = g.arcBegin(u); a < g.arcEnd(u); a++) 
+            {
+                int v = g.dest[a];
+                if (mark[v] == stamp && level[v] == -1) 
+                {
+                    level[v] = level[u] + 1;
+                    if (level[v] == levelSize.size()) levelSize.add(1);
+                    else levelSize.set(level[v], levelSize.get(level[v]) + 1);
+                    queue.add(v);
+                }
+            }
+        }
+        
+        // Smallest level whose removal leaves both sides with at least a fifth of the cities
+        int sepLevel = -1, below = 0, n = nodes.size();
+        for (int L = 1; L + 1 < levelSize.size(); L++) 
+        {
+            below += levelSize.get(L - 1);
+            int above = n - below - levelSize.get(L);
+            if (below * 5 >= n && above * 5 >= n && (sepLevel == -1 || levelSize.get(L) < levelSize.get(sepLevel))) 
+            sepLevel = L;
+        }
+        if (sepLevel == -1) 
+        {
+            // Unbalanced shape: fall back to the median level
+            below = 0;
+            for (sepLevel = 0; sepLevel + 1 < levelSize.size() && (below + levelSize.get(sepLevel)) * 2 < n; sepLevel++) 
+            below += levelSize.get(sepLevel);
+        }
+        
+        IntArrayList lower, upper;
+        int lowStamp = nextStamp++, highStamp = nextStamp++;
+        for (int i = 0; i < n; i++) 
+        {
+            int v = nodes.get(i);
+            if (level[v] == sepLevel) 
+            {
+                rank[v] = top; 
+                order[top] = v; 
+                top--;
+                mark[v] = -1;
+            }
+            else if (level[v] < sepLevel) 
+            { 
+                mark[v] = lowStamp; 
+                lower.add(v); 
+            }
+            else 
+            { 
+                mark[v] = highStamp; 
+                upper.add(v); 
+            }
+        }
+        
+        dissect(g, lower, lowStamp, mark, level, nextStamp, top);
+        dissect(g, upper, highStamp, mark, level, nextStamp, top);
+    }
+
+public:
+    unsigned long structureEpoch;   // Graph structure the contraction belongs to
+    unsigned long metricEpoch;      // Graph epoch the weights were customized at
+    
+    ContractionHierarchy() : nodeCount(0), rank(nullptr), order(nullptr), upOffset(nullptr), upHead(nullptr), upTail(nullptr), 
+                             upWeight(nullptr), upMiddle(nullptr), upArcCount(0), etreeParent(nullptr), distF(nullptr), distB(nullptr), 
+                             parentF(nullptr), parentB(nullptr), structureEpoch(0), metricEpoch(0) {}
+    
+    ~ContractionHierarchy() 
+    { 
+        release(); 
+    }
+    
+    int getShortcutCount() const 
+    { 
+        return upArcCount; 
+    }
+    
+    // Metric-independent contraction: nested dissection order plus fill-in shortcuts
+    void build(const RoadNetworkCSR& g) 
+    {
+        release();
+        int n = nodeCount = g.nodeCount;
+        rank = new int[n]; 
+        order = new int[n];
+        
+        int* mark = new int[n];
+        int* level = new int[n];
+        IntArrayList all;
+        for (int u = 0; u < n; u++) 
+        {
+            mark[u] = 0; 
+            all.add(u);
+        }
+        int nextStamp = 1, top = n - 1;
+        dissect(g, all, 0, mark, level, nextStamp, top);
+        delete[] mark; 
+        delete[] level;
+        
+        // Elimination graph (neighbour lists may contain already-contracted cities)
+        IntArrayList* adj = new IntArrayList[n];
+        PairIndex present;
+        for (int u = 0; u < n; u++) 
+        {
+            for (int a = g.arcBegin(u); a < g.arcEnd(u); a++) 
+            {
+                int v = g.dest[a];
+                if (present.get(u, v) == -1) 
+                {
+                    present.put(u, v, 1); 
+                    adj[u].add(v); 
+                }
+            }
+        }
+        
+        IntArrayList* upLists = new IntArrayList[n];
+        IntArrayList live;
+        for (int r = 0; r < n; r++) 
+        {
+            int x = order[r];
+            live.clear();
+            for (int i = 0; i < adj[x].size(); i++) 
+            {
+                int v = adj[x].get(i);
+                if (rank[v] > r) 
+                live.add(v);
+            }
+            upLists[x] = live;
+            
+            // Connect every pair of remaining neighbours (fill-in)
+            for (int i = 0; i < live.size(); i++) 
+            {
+                for (int j = i + 1; j < live.size(); j++) 
+                {
+                    int a = live.get(i), b = live.get(j);
+                    if (present.get(a, b) == -1) 
+                    {
+                        present.put(a, b, 1); present.put(b, a, 1);
+                        adj[a].add(b); adj[b].add(a);
+                    }
+                }
+            }
+        }
+        
+        // Flatten upward lists into CSR, each segment sorted by city id for binary search
+        upOffset = new int[n + 1];
+        upArcCount = 0;
+        for (int u = 0; u < n; u++) 
+        {
+            upOffset[u] = upArcCount;
+            upArcCount += upLists[u].size();
+        }
+        upOffset[n] = upArcCount;
+        
+        int arcs = upArcCount > 0 ? upArcCount : 1;
+        upHead = new int[arcs]; 
+        upTail = new int[arcs]; 
+        upWeight = new int[arcs]; 
+        upMiddle = new int[arcs];
+        for (int u = 0; u < n; u++) 
+        {
+            int base = upOffset[u];
+            for (int i = 0; i < upLists[u].size(); i++) 
+            {
+                int v = upLists[u].get(i);
+                int j = base + i;
+                while (j > base && upHead[j - 1] > v) 
+                {
+                    upHead[j] = upHead[j - 1]; 
+                    j--;
+                }
+                upHead[j] = v;
+                upTail[base + i] = u;
+            }
+        }
+        
+        etreeParent = new int[n];
+        distF = new int[n]; distB = new int[n]; 
+        parentF = new int[n]; parentB = new int[n];
+        for (int u = 0; u < n; u++) 
+        { 
+            distF[u] = distB[u] = INF; 
+            etreeParent[u] = -1;
+            for (int a = upOffset[u]; a < upOffset[u + 1]; a++) 
+            if (etreeParent[u] == -1 || rank[upHead[a]] < rank[etreeParent[u]]) 
+            etreeParent[u] = upHead[a];
+        }
+        
+        delete[] adj; 
+        delete[] upLists;
+    }
+    
+    // Metric customization: recompute all arc weights from the current road lengths and
+    // block flags. Triangles are processed bottom-up, O(sum of upward degree squared).
+    void customize(const RoadNetworkCSR& g) 
+    {
+        for (int a = 0; a < upArcCount; a++) 
+        { 
+            upWeight[a] = INF; 
+            upMiddle[a] = -1; 
+        }
+        
+        for (int u = 0; u < nodeCount; u++) 
+        {
+            for (int a = g.arcBegin(u); a < g.arcEnd(u); a++) 
+            {
+                int v = g.dest[a];
+                if (g.isBlocked(a) || rank[u] > rank[v]) 
+                continue;
+                int arc = findArc(u, v);
+                if (g.weight[a] < upWeight[arc]) 
+                upWeight[arc] = g.weight[a];
+            }
+        }
+        
+        for (int r = 0; r < nodeCount; r++) 
+        {
+            int x = order[r];
+            for (int i = upOffset[x]; i < upOffset[x + 1]; i++) 
+            {
+                if (upWeight[i] >= INF) 
+                continue;
+                for (int j = i + 1; j < upOffset[x + 1]; j++) 
+                {
+                    if (upWeight[j] >= INF) 
+                    continue;
+                    int p = upHead[i], q = upHead[j];
+                    int arc = arcBetween(p, q);
+                    int via = upWeight[i] + upWeight[j];
+                    if (via < upWeight[arc]) 
+                    {
+                        upWeight[arc] = via;
+                        upMiddle[arc] = x;
+                    }
+                }
+            }
+        }
+    }
+    
+    // Bidirectional upward search. In a CCH every upward neighbour of a city is one of its
+    // elimination-tree ancestors, so each side simply walks its ancestor chain in rank order
+    // and relaxes the upward arcs (no priority queue). Returns the distance (or -1).
+    int query(int s, int t, IntArrayList& path) 
+    {
+        path.clear();
+        if (s < 0 || s >= nodeCount || t < 0 || t >= nodeCount) 
+        return -1;
+        if (s == t) 
+        {
+            path.add(s);
+            return 0;
+        }
+        
+        distF[s] = 0; parentF[s] = -1;
+        distB[t] = 0; parentB[t] = -1;
+        
+        for (int x = s; x != -1; x = etreeParent[x]) 
+        relaxUp(x, distF, parentF);
+        
+        int best = INF, meet = -1;
+        for (int x = t; x != -1; x = etreeParent[x]) 
+        {
+            relaxUp(x, distB, parentB);
+            if (distF[x] < INF && distB[x] < INF && distF[x] + distB[x] < best) 
+            {
+                best = distF[x] + distB[x];
+                meet = x;
+            }
+        }
+        
+        int result = -1;
+        if (meet != -1) 
+        {
+            result = best;
+            
+            // Up-chain from s to the meeting city, then unpack each arc in travel order
+            IntArrayList chain;
+            for (int v = meet; v != s; v = upTail[parentF[v]]) 
+            chain.add(v);
+            chain.add(s);
+            chain.reverse();
+            
+            path.add(s);
+            for (int i = 0; i + 1 < chain.size(); i++) 
+            unpack(chain.get(i), chain.get(i + 1), path);
+            
+            for (int v = meet; v != t; ) 
+            {
+                int low = upTail[parentB[v]];
+                unpack(v, low, path);
+                v = low;
+            }
+        }
+        
+        // Only ancestors were touched: reset them for the next query
+        for (int x = s; x != -1; x = etreeParent[x]) 
+        distF[x] = INF;
+        for (int x = t; x != -1; x = etreeParent[x]) 
+        distB[x] = INF;
+        return result;
+    }
+};
+
+// Two-level zone overlay routing built on CityNode::zone.
+// For every zone, boundary cities (those with a road into another zone) get a precomputed
+// boundary-to-boundary distance table, found by Dijkstra restricted to the zone. A query runs
+// Dijkstra that expands real roads only inside the source and target zones; in every other zone
+// it hops between boundary cities through the table. A closure inside one zone only marks that
+// zone's table dirty.
+class ZoneOverlay 
+{
+private:
+    static const int INF = INT_MAX / 2;
+    
+    int nodeCount;
+    int zoneCount;
+    int* cityZone;          // Zone id of each city
+    int* localIndex;        // Position of each city inside its zone's member list
+    int* boundaryPos;       // Position inside its zone's boundary list, -1 if interior
+    IntArrayList* members;  // Cities of each zone
+    IntArrayList* boundary; // Boundary cities of each zone
+    int** table;            // Per zone: b x b boundary distances
+    int** tableParent;      // Per zone: b x zoneSize predecessor cities (global ids)
+    bool* dirty;            // Zone table needs recomputation
+    
+    // Query scratch
+    int* dist; 
+    int* parent; 
+    bool* viaTable;         // Reached through a table hop rather than a real road
+    IntArrayList touched;
+    
+    void release() 
+    {
+        if (table) 
+        {
+            for (int z = 0; z < zoneCount; z++) 
+            { 
+                delete[] table[z]; 
+                delete[] tableParent[z]; 
+            }
+        }
+        delete[] cityZone; delete[] localIndex; delete[] boundaryPos;
+        delete[] members; delete[] boundary; delete[] table; delete[] tableParent; delete[] dirty;
+        delete[] dist; delete[] parent; delete[] viaTable;
+        cityZone = localIndex = boundaryPos = dist = parent = nullptr;
+        members = boundary = nullptr; 
+        table = tableParent = nullptr; 
+        dirty = viaTable = nullptr;
+        zoneCount = 0;
+    }
+    
+    // Restricted Dijkstra from every boundary city of zone z, staying inside the zone
+    void computeZone(const RoadNetworkCSR& g, int z) 
+    {
+        int b = boundary[z].size();
+        int size = members[z].size();
+        int* localDist = new int[size];
+        MinDistHeap pq;
+        
+        for (int i = 0; i < b; i++) 
+        {
+            int* par = tableParent[z] + i * size;
+            for (int k = 0; k < size; k++) 
+            { 
+                localDist[k] = INF; 
+                par[k] = -1; 
+            }
+            
+            int src = boundary[z].get(i);
+            localDist[localIndex[src]] = 0;
+            pq.clear();
+            pq.push(src, 0);
+            
+            while (!pq.isEmpty()) 
+            {
+                HeapNode top = pq.pop();
+                int u = top.vertex;
+                if (top.dist > localDist[localIndex[u]]) 
+                continue;
+                
+                for (int a = g.arcBegin(u); a < g.arcEnd(u); a++) 
+                {
+                    int v = g.dest[a];
+                    if (g.isBlocked(a) || cityZone[v] != z) 
+                    continue;
+                    int nd = top.dist + g.weight[a];
+                    if (nd < localDist[localIndex[v]]) 
+                    {
+                        localDist[localIndex[v]] = nd;
+                        par[localIndex[v]] = u;
+                        pq.push(v, nd);
+                    }
+                }
+            }
+            
+            for (int j = 0; j < b; j++) 
+            table[z][i * b + j] = localDist[localIndex[boundary[z].get(j)]];
+        }
+        
+        delete[] localDist;
+        dirty[z] = false;
+    }
+    
+    void relax(int u, int v, int nd, bool hop, MinDistHeap& pq) 
+    {
+        if (nd >= dist[v]) 
+        return;
+        if (dist[v] == INF) 
+        touched.add(v);
+        dist[v] = nd; 
+        parent[v] = u; 
+        viaTable[v] = hop;
+        pq.push(v, nd);
+    }
+
+public:
+    unsigned long structureEpoch;   // Graph structure the overlay was built for
+    
+    ZoneOverlay() : nodeCount(0), zoneCount(0), cityZone(nullptr), localIndex(nullptr), boundaryPos(nullptr), 
+                    members(nullptr), boundary(nullptr), table(nullptr), tableParent(nullptr), dirty(nullptr), 
+                    dist(nullptr), parent(nullptr), viaTable(nullptr), structureEpoch(0) {}
+    
+    ~ZoneOverlay() 
+    { 
+        release(); 
+    }
+    
+    int getZoneCount() const { return zoneCount; }
+    
+    int getBoundaryCount() const 
+    {
+        int total = 0;
+        for (int z = 0; z < zoneCount; z++) 
+        total += boundary[z].size();
+        return total;
+    }
+    
+    // Partition cities by zone name, find boundary cities and compute every zone table
+    void build(const RoadNetworkCSR& g, CityNode* cities) 
+    {
+        release();
+        int n = nodeCount = g.nodeCount;
+        cityZone = new int[n]; 
+        localIndex = new int[n]; 
+        boundaryPos = new int[n];
+        
+        NameIndex zoneIds;
+        for (int u = 0; u < n; u++) 
+        {
+            int z = zoneIds.find(cities[u].zone);
+            if (z == -1) 
+            {
+                z = zoneCount++;
+                zoneIds.insert(cities[u].zone, z);
+            }
+            cityZone[u] = z;
+        }
+        
+        members = new IntArrayList[zoneCount > 0 ? zoneCount : 1];
+        boundary = new IntArrayList[zoneCount > 0 ? zoneCount : 1];
+        for (int u = 0; u < n; u++) 
+        {
+            localIndex[u] = members[cityZone[u]].size();
+            members[cityZone[u]].add(u);
+            
+            boundaryPos[u] = -1;
+            for (int a = g.arcBegin(u); a < g.arcEnd(u); a++) 
+            {
+                if (cityZone[g.dest[a]] != cityZone[u]) 
+                {
+                    boundaryPos[u] = boundary[cityZone[u]].size();
+                    boundary[cityZone[u]].add(u);
+                    break;
+                }
+            }
+        }
+        
+        table = new int*[zoneCount > 0 ? zoneCount : 1];
+        tableParent = new int*[zoneCount > 0 ? zoneCount : 1];
+        dirty = new bool[zoneCount > 0 ? zoneCount : 1];
+        for (int z = 0; z < zoneCount; z++) 
+        {
+            int b = boundary[z].size();
+            table[z] = new int[b * b > 0 ? b * b : 1];
+            tableParent[z] = new int[b * members[z].size() > 0 ? b * members[z].size() : 1];
+            computeZone(g, z);
+        }
+        
+        dist = new int[n]; 
+        parent = new int[n]; 
+        viaTable = new bool[n];
+        for (int u = 0; u < n; u++) 
+        dist[u] = INF;
+    }
+    
+    // A road changed state: only a road inside a single zone affects that zone's table
+    void roadChanged(int u, int v) 
+    {
+        if (cityZone && u < nodeCount && v < nodeCount && cityZone[u] == cityZone[v]) 
+        dirty[cityZone[u]] = true;
+    }
+    
+    // Recompute tables of zones touched by closures since the last query
+    int refresh(const RoadNetworkCSR& g) 
+    {
+        int recomputed = 0;
+        for (int z = 0; z < zoneCount; z++) 
+        {
+            if (dirty[z]) 
+            {
+                computeZone(g, z);
+                recomputed++;
+            }
+        }
+        return recomputed;
+    }
+    
+    int query(const RoadNetworkCSR& g, int s, int t, IntArrayList& path) 
+    {
+        path.clear();
+        if (s < 0 || s >= nodeCount || t < 0 || t >= nodeCount) 
+        return -1;
+        
+        int zs = cityZone[s], zt = cityZone[t];
+        MinDistHeap pq;
+        touched.clear();
+        touched.add(s);
+        dist[s] = 0; 
+        parent[s] = -1; 
+        viaTable[s] = false;
+        pq.push(s, 0);
+        
+        while (!pq.isEmpty()) 
+        {
+            HeapNode top = pq.pop();
+            int u = top.vertex;
+            if (top.dist > dist[u]) 
+            continue;
+            if (u == t) 
+            break;
+            
+            int zu = cityZone[u];
+            bool local = (zu == zs || zu == zt);
+            for (int a = g.arcBegin(u); a < g.arcEnd(u); a++) 
+            {
+                int v = g.dest[a];
+                if (g.isBlocked(a) || (!local && cityZone[v] == zu)) 
+                continue; // Inside a middle zone only the table is used
+                relax(u, v, top.dist + g.weight[a], false, pq);
+            }
+            
+            if (!local) 
+            {
+                int b = boundary[zu].size();
+                int* row = table[zu] + boundaryPos[u] * b;
+                for (int j = 0; j < b; j++) 
+                if (row[j] < INF) 
+                relax(u, boundary[zu].get(j), top.dist + row[j], true, pq);
+            }
+        }
+        
+        int result = -1;
+        if (dist[t] < INF) 
+        {
+            result = dist[t];
+            for (int v = t; v != -1; v = parent[v]) 
+            {
+                path.add(v);
+                if (viaTable[v]) 
+                {
+                    // Expand the table hop parent[v] -> v using the zone's predecessor links
+                    int z = cityZone[v];
+                    int* par = tableParent[z] + boundaryPos[parent[v]] * members[z].size();
+                    for (int w = par[localIndex[v]]; w != parent[v]; w = par[localIndex[w]]) 
+                    path.add(w);
+                }
+            }
+            path.reverse();
+        }
+        
+        for (int i = 0; i < touched.size(); i++) 
+        dist[touched.get(i)] = INF;
+        return result;
+    }
+};
+
+// All-pairs distance matrix, computed with a cache-blocked Floyd-Warshall.
+// Rows are padded to a multiple of 8 so the min-plus inner loop runs 8 lanes at a time
+// (AVX2 when the compiler targets it, otherwise a plain loop the compiler can vectorize).
+// A road that becomes cheaper (reopened or newly built) is folded in with an O(n^2) update.
+class DistanceMatrix 
+{
+private:
+    static const int TILE = 64;
+    
+    int* d;         // n x stride, INF = unreachable
+    int n; 
+    int stride;
+    
+    // c[j] = min(c[j], a + b[j]) for j in [0, len)
+    static void minPlusRow(int* c, const int* b, int a, int len) 
+    {
+        int j = 0;
+#ifdef __AVX2__
+        __m256i va = _mm256_set1_epi32(a);
+        for (; j + 8 <= len; j += 8) 
+        {
+            __m256i vb = _mm256_loadu_si256((const __m256i*)(b + j));
+            __m256i vc = _mm256_loadu_si256((const __m256i*)(c + j));
+            vc = _mm256_min_epi32(vc, _mm256_add_epi32(va, vb));
+            _mm256_storeu_si256((__m256i*)(c + j), vc);
+        }
+#endif
+        for (; j < len; j++) 
+        {
+            int via = a + b[j];
+            if (via < c[j]) c[j] = via;
+        }
+    }
+    
+    // Tile update with k outermost (needed while the tile being written is also read)
+    void fwTile(int i0, int i1, int j0, int j1, int k0, int k1) 
+    {
+        for (int k = k0; k < k1; k++) 
+        {
+            for (int i = i0; i < i1; i++) 
+            {
+                int a = d[i * stride + k];
+                if (a < INF) 
+                minPlusRow(d + i * stride + j0, d + k * stride + j0, a, j1 - j0);
+            }
+        }
+    }
+    
+    // Independent tile: plain min-plus product C = min(C, A * B). Each output row of the
+    // tile is kept in a local accumulator (registers under AVX2) across the whole k loop.
+    void minPlusTile(int i0, int j0, int k0) 
+    {
+        for (int i = i0; i < i0 + TILE; i++) 
+        {
+            int* row = d + i * stride + j0;
+            const int* arow = d + i * stride + k0;
+#ifdef __AVX2__
+            __m256i acc[TILE / 8];
+            for (int x = 0; x < TILE / 8; x++) 
+            acc[x] = _mm256_loadu_si256((const __m256i*)(row + 8 * x));
+            for (int k = 0; k < TILE; k++) 
+            {
+                if (arow[k] >= INF) continue;
+                __m256i va = _mm256_set1_epi32(arow[k]);
+                const int* b = d + (k0 + k) * stride + j0;
+                for (int x = 0; x < TILE / 8; x++) 
+                acc[x] = _mm256_min_epi32(acc[x], _mm256_add_epi32(va, _mm256_loadu_si256((const __m256i*)(b + 8 * x))));
+            }
+            for (int x = 0; x < TILE / 8; x++) 
+            _mm256_storeu_si256((__m256i*)(row + 8 * x), acc[x]);
+#else
+            int acc[TILE];
+            for (int j = 0; j < TILE; j++) 
+            acc[j] = row[j];
+            for (int k = 0; k < TILE; k++) 
+            {
+                int a = arow[k];
+                if (a >= INF) continue;
+                const int* b = d + (k0 + k) * stride + j0;
+                for (int j = 0; j < TILE; j++) 
+                acc[j] = (a + b[j] < acc[j]) ? a + b[j] : acc[j];
+            }
+            for (int j = 0; j < TILE; j++) 
+            row[j] = acc[j];
+#endif
+        }
+    }
+
+public:
+    static const int INF = INT_MAX / 2;
+    
+    unsigned long builtEpoch;   // Graph epoch the matrix reflects
+    
+    DistanceMatrix() : d(nullptr), n(0), stride(0), builtEpoch(0) {}
+    
+    ~DistanceMatrix() 
+    { 
+        delete[] d; 
+    }
+    
+    int size() const { return n; }
+    
+    int get(int u, int v) const 
+    { 
+        return d[u * stride + v]; 
+    }
+    
+    void compute(const RoadNetworkCSR& g) 
+    {
+        if (g.nodeCount != n || !d) 
+        {
+            delete[] d;
+            n = g.nodeCount;
+            stride = ((n + TILE - 1) / TILE) * TILE;
+            d = new int[(stride > 0 ? stride : 1) * (stride > 0 ? stride : 1)];
+        }
+        
+        for (int i = 0; i < stride * stride; i++) 
+        d[i] = INF;
+        for (int u = 0; u < n; u++) 
+        {
+            d[u * stride + u] = 0;
+            for (int a = g.arcBegin(u); a < g.arcEnd(u); a++) 
+            {
+                if (!g.isBlocked(a) && g.weight[a] < d[u * stride + g.dest[a]]) 
+                d[u * stride + g.dest[a]] = g.weight[a];
+            }
+        }
+        
+        // Blocked Floyd-Warshall over TILE x TILE tiles (padding rows/columns stay INF)
+        int tiles = stride / TILE;
+        for (int kb = 0; kb < tiles; kb++) 
+        {
+            int k0 = kb * TILE, k1 = k0 + TILE;
+            fwTile(k0, k1, k0, k1, k0, k1);                     // 1. Diagonal tile
+            
+            for (int b = 0; b < tiles; b++)                     // 2. Its row and column
+            {
+                if (b == kb) continue;
+                int b0 = b * TILE, b1 = b0 + TILE;
+                fwTile(k0, k1, b0, b1, k0, k1);
+                fwTile(b0, b1, k0, k1, k0, k1);
+            }
+            
+            for (int ib = 0; ib < tiles; ib++)                  // 3. Everything else
+            {
+                if (ib == kb) continue;
+                for (int jb = 0; jb < tiles; jb++) 
+                {
+                    if (jb == kb) continue;
+                    minPlusTile(ib * TILE, jb * TILE, k0);
+                }
+            }
+        }
+    }
+    
+    // Road (u,v) now costs w (lower than before): every pair may shortcut through it once
+    void roadCheaper(int u, int v, int w) 
+    {
+        if (w < d[u * stride + v]) 
+        {
+            d[u * stride + v] = w; 
+            d[v * stride + u] = w;
+        }
+        for (int i = 0; i < n; i++) 
+        {
+            int* row = d + i * stride;
+            if (row[u] < INF) minPlusRow(row, d + v * stride, row[u] + w, n);
+            if (row[v] < INF) minPlusRow(row, d + u * stride, row[v] + w, n);
+        }
+    }
+};
+
+const int MAX_ROUTE_OPTIONS = 5;
+
+// Routing engines selectable on MapGraph
+const int ROUTE_ENGINE_DIJKSTRA = 0;   // Dijkstra / cached hub trees
+const int ROUTE_ENGINE_CH = 1;         // Customizable contraction hierarchy
+const int ROUTE_ENGINE_ZONES = 2;      // Zone overlay (multi-level)
+const int ROUTE_ENGINE_MATRIX = 3;     // All-pairs distance matrix
+
+// The all-pairs matrix needs n^2 ints; above this size the matrix engine falls back to Dijkstra
+const int MATRIX_MAX_CITIES = 8192;
+
+// Single-source shortest-path tree (distances + predecessor links) from one origin hub.
+// Stamped with the graph epoch it was built at, so any road/city change marks it stale.
+struct ShortestPathTree 
+{
+    int source;
+    unsigned long builtEpoch;
+    int* dist;      // INT_MAX = unreachable
+    int* parent;    // -1 = root or unreachable
+    int size;
+    long long departMinute; // -1 = road distances (km); otherwise travel minutes leaving at this time
+    
+    ShortestPathTree(int src, long long depart = -1) : source(src), builtEpoch(0), dist(nullptr), parent(nullptr), size(0), 
+                                                       departMinute(depart) {}
+    
+    ~ShortestPathTree() 
+    {
+        delete[] dist; 
+        delete[] parent;
+    }
+};
+
+class MapGraph 
+{
+public:
+    CityNode* cities; int cityCount; int cityCapacity;
+    NameIndex cityIndex; // City name -> index into cities[]
+    PairIndex roadIndex; // (u,v) -> index of the u->v edge in cities[u].edges
+    
+    // Store found paths for user selection (best K routes, shortest first)
+    IntArrayList availablePaths[MAX_ROUTE_OPTIONS]; 
+    int availablePathDistances[MAX_ROUTE_OPTIONS];
+    int pathCount;
+
+private:
+    // Dijkstra scratch buffers, reused across searches (sized to cityCount on demand)
+    int* distBuf; 
+    int* parentBuf; 
+    bool* bannedNodeBuf; 
+    bool* bannedNextBuf; 
+    bool* pendingTargetBuf;     // distanceTable: target city not settled yet
+    int scratchSize;
+    
+    // Bumped by every change that can alter a shortest path (cities, roads, block status)
+    unsigned long graphEpoch;
+    // Bumped only when cities or roads are added (block status is patched into the CSR in place)
+    unsigned long structureEpoch;
+    
+    RoadNetworkCSR csr;
+    
+    int routingEngine;
+    ContractionHierarchy ch;
+    ZoneOverlay overlay;
+    DistanceMatrix matrix;
+    
+    // Mirror a block flag change on edge 'edgeIndex' of city u into the CSR snapshot
+    void patchBlocked(int u, int edgeIndex, bool blocked) 
+    {
+        if (csr.builtEpoch == structureEpoch) 
+        csr.setBlocked(csr.arcBegin(u) + edgeIndex, blocked);
+    }
+    
+    // Cached shortest-path trees, one per origin hub
+    ShortestPathTree** trees; 
+    int treeCount; 
+    int treeCapacity;
+    
+    // Warehouses: hub slot -> city, open flag (1/0), and each city's nearest open hub slot
+    IntArrayList hubCities;
+    IntArrayList hubOpenFlags;
+    int* nearestHubBuf;
+    unsigned long hubVersion;       // Bumped when hubs are added, opened or closed
+    unsigned long hubAssignEpoch;   // graphEpoch the assignment was computed at
+    unsigned long hubAssignVersion; // hubVersion the assignment was computed at
+    
+    // Multi-source Dijkstra seeded with every open hub at distance 0: each city ends up
+    // labelled with the hub whose search reached it first, i.e. its nearest open hub.
+    void assignNearestHubs() 
+    {
+        ensureScratch();
+        delete[] nearestHubBuf;
+        nearestHubBuf = new int[cityCount > 0 ? cityCount : 1];
+        
+        int* dist = distBuf;
+        for (int i = 0; i < cityCount; i++) 
+        { 
+            dist[i] = INT_MAX; 
+            nearestHubBuf[i] = -1; 
+        }
+        
+        const RoadNetworkCSR& g = getCSR();
+        MinDistHeap pq;
+        for (int h = 0; h < hubCities.size(); h++) 
+        {
+            int c = hubCities.get(h);
+            if (hubOpenFlags.get(h) && dist[c] != 0) 
+            {
+                dist[c] = 0;
+                nearestHubBuf[c] = h;
+                pq.push(c, 0);
+            }
+        }
+        
+        while (!pq.isEmpty()) 
+        {
+            HeapNode top = pq.pop();
+            int u = top.vertex;
+            if (top.dist > dist[u]) 
+            continue;
+            
+            for (int a = g.arcBegin(u); a < g.arcEnd(u); a++) 
+            {
+                if (g.isBlocked(a)) 
+                continue;
+                
+                int v = g.dest[a];
+                int nd = top.dist + g.weight[a];
+                if (nd < dist[v]) 
+                {
+                    dist[v] = nd;
+                    nearestHubBuf[v] = nearestHubBuf[u];
+                    pq.push(v, nd);
+                }
+            }
+        }
+        hubAssignEpoch = graphEpoch;
+        hubAssignVersion = hubVersion;
+    }
+    
+    // Full Dijkstra from tree->source (no early exit), refreshing the tree in place.
+    // Time-dependent trees evaluate each road's traffic profile at the label's time.
+    void buildTree(ShortestPathTree* tree) 
+    {
+        bool timed = (tree->departMinute >= 0);
+        const TrafficProfiles& traffic = trafficProfiles();
+        if (tree->size < cityCount) 
+        {
+            delete[] tree->dist; 
+            delete[] tree->parent;
+            tree->size = cityCapacity;
+            tree->dist = new int[tree->size]; 
+            tree->parent = new int[tree->size];
+        }
+        
+        int* dist = tree->dist;
+        int* parent = tree->parent;
+        for (int i = 0; i < cityCount; i++) 
+        { 
+            dist[i] = INT_MAX; 
+            parent[i] = -1; 
+        }
+        
+        const RoadNetworkCSR& g = getCSR();
+        MinDistHeap pq;
+        dist[tree->source] = 0;
+        pq.push(tree->source, 0);
+        
+        while (!pq.isEmpty()) 
+        {
+            HeapNode top = pq.pop();
+            int u = top.vertex;
+            if (top.dist > dist[u]) 
+            continue;
+            
+            for (int a = g.arcBegin(u); a < g.arcEnd(u); a++) 
+            {
+                if (g.isBlocked(a)) 
+                continue;
+                
+                int v = g.dest[a];
+                int nd = top.dist + (timed ? traffic.delay(g.profile[a], g.weight[a], tree->departMinute + top.dist) : g.weight[a]);
+                if (nd < dist[v]) 
+                {
+                    dist[v] = nd;
+                    parent[v] = u;
+                    pq.push(v, nd);
+                }
+            }
+        }
+        tree->builtEpoch = graphEpoch;
+    }
+    
+    void ensureScratch() 
+    {
+        if (scratchSize >= cityCount) 
+        return;
+        delete[] distBuf; delete[] parentBuf; delete[] bannedNodeBuf; delete[] bannedNextBuf; delete[] pendingTargetBuf;
+        scratchSize = cityCapacity;
+        distBuf = new int[scratchSize]; 
+        parentBuf = new int[scratchSize];
+        bannedNodeBuf = new bool[scratchSize]; 
+        bannedNextBuf = new bool[scratchSize];
+        pendingTargetBuf = new bool[scratchSize];
+        for (int i = 0; i < scratchSize; i++) 
+        { 
+            bannedNodeBuf[i] = false; 
+            bannedNextBuf[i] = false; 
+            pendingTargetBuf[i] = false; 
+        }
+    }
+    
+    // Core Dijkstra. Cities flagged in bannedNodeBuf are never entered, and roads leaving
+    // 'spur' towards a city flagged in bannedNextBuf are ignored (both used by Yen's algorithm).
+    int runDijkstra(int start, int end, IntArrayList& path, int spur) 
+    {
+        path.clear();
+        int* dist = distBuf;
+        int* parent = parentBuf;
+        for (int i = 0; i < cityCount; i++) 
+        { 
+            dist[i] = INT_MAX; 
+            parent[i] = -1; 
+        }
+        
+        const RoadNetworkCSR& g = getCSR();
+        MinDistHeap pq;
+        dist[start] = 0;
+        pq.push(start, 0);
+        
+        while (!pq.isEmpty()) 
+        {
+            HeapNode top = pq.pop();
+            int u = top.vertex;
+            if (top.dist > dist[u]) 
+            continue; // Stale entry
+            if (u == end) 
+            break;    // Target settled, distance is final
+            
+            for (int a = g.arcBegin(u); a < g.arcEnd(u); a++) 
+            {
+                int v = g.dest[a];
+                if (g.isBlocked(a) || bannedNodeBuf[v]) 
+                continue;
+                if (u == spur && bannedNextBuf[v]) 
+                continue;
+                
+                int nd = top.dist + g.weight[a];
+                if (nd < dist[v]) 
+                {
+                    dist[v] = nd;
+                    parent[v] = u;
+                    pq.push(v, nd);
+                }
+            }
+        }
+        
+        if (dist[end] == INT_MAX) 
+        return -1;
+        
+        for (int v = end; v != -1; v = parent[v]) 
+        path.add(v);
+        path.reverse();
+        return dist[end];
+    }
+
+public:
+    MapGraph() : cityCount(0), cityCapacity(15), pathCount(0), 
+                 distBuf(nullptr), parentBuf(nullptr), bannedNodeBuf(nullptr), bannedNextBuf(nullptr), pendingTargetBuf(nullptr), 
+                 scratchSize(0), 
+                 graphEpoch(1), structureEpoch(1), routingEngine(ROUTE_ENGINE_DIJKSTRA), treeCount(0), treeCapacity(4), 
+                 nearestHubBuf(nullptr), hubVersion(1), hubAssignEpoch(0), hubAssignVersion(0) 
+    { 
+        cities = new CityNode[cityCapacity]; 
+        trees = new ShortestPathTree*[treeCapacity];
+    }
+    
+    // Destructor to prevent memory leak
+    ~MapGraph() 
+    {
+        delete[] cities;
+        delete[] distBuf; delete[] parentBuf; delete[] bannedNodeBuf; delete[] bannedNextBuf; delete[] pendingTargetBuf;
+        for (int i = 0; i < treeCount; i++) 
+        delete trees[i];
+        delete[] trees;
+        delete[] nearestHubBuf;
+    }
+    
+    unsigned long getEpoch() const 
+    { 
+        return graphEpoch; 
+    }
+    
+    // CSR snapshot of the current network, rebuilt lazily after cities or roads are added
+    const RoadNetworkCSR& getCSR() 
+    {
+        if (csr.builtEpoch != structureEpoch) 
+        {
+            csr.build(cities, cityCount);
+            csr.builtEpoch = structureEpoch;
+        }
+        return csr;
+    }
+    
+    void setRoutingEngine(int engine) 
+    { 
+        routingEngine = engine; 
+    }
+    
+    int getRoutingEngine() const 
+    { 
+        return routingEngine; 
+    }
+    
+    // Contraction hierarchy for the current network. A structural change redoes the
+    // contraction; a block/unblock only re-customizes the arc weights.
+    ContractionHierarchy& getCH() 
+    {
+        const RoadNetworkCSR& g = getCSR();
+        if (ch.structureEpoch != structureEpoch) 
+        {
+            ch.build(g);
+            ch.structureEpoch = structureEpoch;
+            ch.metricEpoch = 0;
+        }
+        if (ch.metricEpoch != graphEpoch) 
+        {
+            ch.customize(g);
+            ch.metricEpoch = graphEpoch;
+        }
+        return ch;
+    }
+    
+    // Zone overlay for the current network. Structural changes rebuild it; closures only
+    // recompute the tables of the zones they fall in.
+    ZoneOverlay& getOverlay() 
+    {
+        const RoadNetworkCSR& g = getCSR();
+        if (overlay.structureEpoch != structureEpoch) 
+        {
+            overlay.build(g, cities);
+            overlay.structureEpoch = structureEpoch;
+        }
+        else 
+        overlay.refresh(g);
+        return overlay;
+    }
+    
+    // All-pairs matrix for the current network (recomputed only when it went stale)
+    DistanceMatrix& getMatrix() 
+    {
+        if (matrix.builtEpoch != graphEpoch) 
+        {
+            matrix.compute(getCSR());
+            matrix.builtEpoch = graphEpoch;
+        }
+        return matrix;
+    }
+    
+    bool matrixUsable() const 
+    {
+        return routingEngine == ROUTE_ENGINE_MATRIX && cityCount <= MATRIX_MAX_CITIES;
+    }
+    
+    // Rebuild a shortest path from the matrix: from each city step to the neighbour that
+    // keeps road + remaining distance equal to the table entry
+    int matrixRoute(int start, int end, IntArrayList& path) 
+    {
+        path.clear();
+        if (start < 0 || start >= cityCount || end < 0 || end >= cityCount) 
+        return -1;
+        DistanceMatrix& dm = getMatrix();
+        if (dm.get(start, end) >= DistanceMatrix::INF) 
+        return -1;
+        
+        const RoadNetworkCSR& g = getCSR();
+        path.add(start);
+        for (int x = start; x != end; ) 
+        {
+            int next = -1;
+            for (int a = g.arcBegin(x); a < g.arcEnd(x) && next == -1; a++) 
+            {
+                if (!g.isBlocked(a) && g.weight[a] + dm.get(g.dest[a], end) == dm.get(x, end)) 
+                next = g.dest[a];
+            }
+            if (next == -1) 
+            return -1; // Only possible if the matrix were inconsistent
+            path.add(next);
+            x = next;
+        }
+        return dm.get(start, end);
+    }
+    
+    // Distance only (used for quotes): a single table lookup in matrix mode
+    int routeDistance(int start, int end) 
+    {
+        if (matrixUsable() && start >= 0 && start < cityCount && end >= 0 && end < cityCount) 
+        {
+            int dist = getMatrix().get(start, end);
+            return dist >= DistanceMatrix::INF ? -1 : dist;
+        }
+        IntArrayList path;
+        return routeFromHub(start, end, path);
+    }
+
+    // Road distances between every pair of the k given cities: out[i * k + j] is the km from
+    // cities[i] to cities[j], or 'unreachable'. One search per row, stopped once all k are settled.
+    void distanceTable(const int* cities, int k, int* out, int unreachable) 
+    {
+        if (matrixUsable()) 
+        {
+            const DistanceMatrix& dm = getMatrix();
+            for (int i = 0; i < k; i++) 
+            for (int j = 0; j < k; j++) 
+            {
+                int d = dm.get(cities[i], cities[j]);
+                out[i * k + j] = d >= DistanceMatrix::INF ? unreachable : d;
+            }
+            return;
+        }
+
+        ensureScratch();
+        const RoadNetworkCSR& g = getCSR();
+        for (int i = 0; i < k; i++) 
+        {
+            int* dist = distBuf;
+            for (int v = 0; v < cityCount; v++) 
+            dist[v] = INT_MAX;
+            int pending = 0;
+            for (int j = 0; j < k; j++) 
+            if (!pendingTargetBuf[cities[j]]) 
+            {
+                pendingTargetBuf[cities[j]] = true;
+                pending++;
+            }
+
+            MinDistHeap pq;
+            dist[cities[i]] = 0;
+            pq.push(cities[i], 0);
+            while (!pq.isEmpty() && pending > 0) 
+            {
+                HeapNode top = pq.pop();
+                int u = top.vertex;
+                if (top.dist > dist[u]) 
+                continue;
+                if (pendingTargetBuf[u]) 
+                {
+                    pendingTargetBuf[u] = false;
+                    pending--;
+                }
+                for (int a = g.arcBegin(u); a < g.arcEnd(u); a++) 
+                {
+                    int v = g.dest[a];
+                    if (g.isBlocked(a)) 
+                    continue;
+                    int nd = top.dist + g.weight[a];
+                    if (nd < dist[v]) 
+                    {
+                        dist[v] = nd;
+                        pq.push(v, nd);
+                    }
+                }
+            }
+            for (int j = 0; j < k; j++) 
+            {
+                pendingTargetBuf[cities[j]] = false;
+                out[i * k + j] = dist[cities[j]] == INT_MAX ? unreachable : dist[cities[j]];
+            }
+        }
+    }
+
+    // Cached tree for 'source' of the given kind (static or time-dependent), created on first use
+    ShortestPathTree* findTree(int source, bool timed) 
+    {
+        for (int i = 0; i < treeCount; i++) 
+        if (trees[i]->source == source && (trees[i]->departMinute >= 0) == timed) 
+        return trees[i];
+        
+        if (treeCount == treeCapacity) 
+        {
+            ShortestPathTree** newTrees = new ShortestPathTree*[treeCapacity * 2];
+            for (int i = 0; i < treeCount; i++) 
+            newTrees[i] = trees[i];
+            delete[] trees; 
+            trees = newTrees; 
+            treeCapacity *= 2;
+        }
+        ShortestPathTree* tree = new ShortestPathTree(source, timed ? 0 : -1);
+        trees[treeCount++] = tree;
+        return tree;
+    }
+    
+    // Shortest-path tree rooted at 'source', rebuilt only if the graph changed since the last build
+    ShortestPathTree* getTree(int source) 
+    {
+        if (source < 0 || source >= cityCount) 
+        return nullptr;
+        
+        ShortestPathTree* tree = findTree(source, false);
+        if (tree->builtEpoch != graphEpoch) 
+        buildTree(tree);
+        return tree;
+    }
+    
+    // Fastest-route tree from 'source' for one departure minute. Dispatching many parcels
+    // from a hub within the same simulated minute reuses a single time-dependent search.
+    ShortestPathTree* getFastestTree(int source, long long departMinute) 
+    {
+        if (source < 0 || source >= cityCount) 
+        return nullptr;
+        
+        ShortestPathTree* tree = findTree(source, true);
+        if (tree->builtEpoch != graphEpoch || tree->departMinute != departMinute) 
+        {
+            tree->departMinute = departMinute;
+            buildTree(tree);
+        }
+        return tree;
+    }
+    
+    // Fastest route from a hub at 'departMinute' (travel minutes, -1 if unreachable)
+    int fastestFromHub(int hub, int end, long long departMinute, IntArrayList& path) 
+    {
+        path.clear();
+        ShortestPathTree* tree = getFastestTree(hub, departMinute);
+        if (!tree || end < 0 || end >= cityCount || tree->dist[end] == INT_MAX) 
+        return -1;
+        
+        for (int v = end; v != -1; v = tree->parent[v]) 
+        path.add(v);
+        path.reverse();
+        return tree->dist[end];
+    }
+    
+    // Register a city as a warehouse hub (open). Returns its hub slot; existing hubs keep theirs.
+    int addHub(int city) 
+    {
+        if (city < 0 || city >= cityCount) 
+        return -1;
+        int slot = getHubSlot(city);
+        if (slot != -1) 
+        return slot;
+        hubCities.add(city);
+        hubOpenFlags.add(1);
+        hubVersion++;
+        return hubCities.size() - 1;
+    }
+    
+    int getHubSlot(int city) const 
+    {
+        for (int h = 0; h < hubCities.size(); h++) 
+        if (hubCities.get(h) == city) 
+        return h;
+        return -1;
+    }
+    
+    int getHubCount() const { return hubCities.size(); }
+    int getHubCity(int slot) const { return hubCities.get(slot); }
+    bool isHubOpen(int slot) const { return hubOpenFlags.get(slot) != 0; }
+    
+    void setHubOpen(int slot, bool open) 
+    {
+        if (slot < 0 || slot >= hubCities.size() || isHubOpen(slot) == open) 
+        return;
+        hubOpenFlags.set(slot, open ? 1 : 0);
+        hubVersion++;
+    }
+    
+    // Nearest open hub (slot) for deliveries to 'city', -1 if no open hub can reach it.
+    // The assignment is shared by all cities and recomputed only after road or hub changes.
+    int nearestHub(int city) 
+    {
+        if (city < 0 || city >= cityCount) 
+        return -1;
+        if (hubAssignEpoch != graphEpoch || hubAssignVersion != hubVersion) 
+        assignNearestHubs();
+        return nearestHubBuf[city];
+    }
+    
+    // Route from a hub using its cached tree: O(path length) once the tree is built.
+    // Returns the distance, or -1 if 'end' is unreachable.
+    int routeFromHub(int hub, int end, IntArrayList& path) 
+    {
+        path.clear();
+        if (routingEngine == ROUTE_ENGINE_CH) 
+        return (hub >= 0 && hub < cityCount) ? getCH().query(hub, end, path) : -1;
+        if (routingEngine == ROUTE_ENGINE_ZONES) 
+        return getOverlay().query(csr, hub, end, path);
+        if (matrixUsable()) 
+        return matrixRoute(hub, end, path);
+        
+        ShortestPathTree* tree = getTree(hub);
+        if (!tree || end < 0 || end >= cityCount || tree->dist[end] == INT_MAX) 
+        return -1;
+        
+        for (int v = end; v != -1; v = tree->parent[v]) 
+        path.add(v);
+        path.reverse();
+        return tree->dist[end];
+    }
+
+    
+    // Storage grows geometrically. Returns -1 if a city with this name already exists.
+    int addCity(const string& name, const string& zone) 
+    { 
+        if (cityIndex.find(name) != -1) 
+        return -1; 
+        
+        if (cityCount == cityCapacity) 
+        {
+            CityNode* newCities = new CityNode[cityCapacity * 2];
+            for (int i = 0; i < cityCount; i++) 
+            newCities[i] = cities[i];
+            delete[] cities; 
+            cities = newCities; 
+            cityCapacity *= 2;
+        }
+        
+        cities[cityCount] = CityNode(name, zone); 
+        cityIndex.insert(name, cityCount);
+        graphEpoch++;
+        structureEpoch++;
+        return cityCount++; 
+    }
+    
+    // Returns false (and adds nothing) for self-loops or if u and v are already connected
+    bool addRoad(int u, int v, int dist) 
+    { 
+        if (u == v || roadIndex.get(u, v) != -1) 
+        return false;
+        
+        roadIndex.put(u, v, cities[u].edges.size());
+        roadIndex.put(v, u, cities[v].edges.size());
+        int prof = TrafficProfiles::classify(dist);
+        cities[u].edges.add(Edge(v, dist, prof)); 
+        cities[v].edges.add(Edge(u, dist, prof)); 
+        bool matrixFresh = (matrix.builtEpoch == graphEpoch && matrix.size() == cityCount);
+        graphEpoch++;
+        structureEpoch++;
+        if (matrixFresh) 
+        {
+            // A new road can only make distances shorter
+            matrix.roadCheaper(u, v, dist);
+            matrix.builtEpoch = graphEpoch;
+        }
+        return true;
+    }
+    
+    bool hasRoad(int u, int v) const 
+    { 
+        return roadIndex.get(u, v) != -1; 
+    }
+    
+    // Length of road (u,v) whether open or blocked, -1 if there is no such road
+    int roadLength(int u, int v) 
+    {
+        int slot = roadIndex.get(u, v);
+        return slot == -1 ? -1 : cities[u].edges.getRef(slot).weight;
+    }
+    
+    int getCityIndex(const string& name) 
+    { 
+        return cityIndex.find(name); 
+    }
+    
+    string getZone(const string& name) 
+    {
+        int idx = getCityIndex(name);
+        if(idx != -1) 
+        return cities[idx].zone;
+
+        return "Unknown";
+    }
+
+    // Blocks a random road; returns false if none was picked, otherwise reports its ends in u/v
+    bool blockRandomRoad(int& u, int& v) 
+    {
+        if (cityCount < 2) 
+        return false;
+        u = rand() % cityCount;
+        if (cities[u].edges.size() > 0) 
+        {
+            int eIdx = rand() % cities[u].edges.size();
+            v = cities[u].edges.getRef(eIdx).dest;
+            setRoadStatus(u, v, true); // Both directions
+            cout << ">>> [ALERT] Road near " << cities[u].name << " is now BLOCKED!\n";
+            return true;
+        }
+        return false;
+    }
+
+    void displayNetwork() 
+    {
+        clearScreen();
+        cout << "\n=========================================\n      LOGISTICS NETWORK MAP VIEW\n=========================================\n";
+        const RoadNetworkCSR& g = getCSR();
+        for(int i=0; i<cityCount; i++) 
+        {
+            cout << " [" << cities[i].zone << "] " << left << setw(12) << cities[i].name << " connects to:\n";
+            
+            for(int a=g.arcBegin(i); a<g.arcEnd(i); a++) 
+            {
+                cout << "    --> " << setw(12) << cities[g.dest[a]].name << " | " << g.weight[a] << "km";
+                if(g.isBlocked(a)) cout << " [BLOCKED]";
+                cout << endl;
+            }
+            cout << "-----------------------------------------\n";
+        }
+    }
+
+    // Dijkstra shortest path (binary heap, O(E log V)). Blocked roads are skipped.
+    // Fills 'path' with city indices from start to end and returns the distance, or -1 if unreachable.
+    int shortestPath(int start, int end, IntArrayList& path) 
+    {
+        path.clear();
+        if (start < 0 || start >= cityCount || end < 0 || end >= cityCount) 
+        return -1;
+        
+        if (routingEngine == ROUTE_ENGINE_CH) 
+        return getCH().query(start, end, path);
+        if (routingEngine == ROUTE_ENGINE_ZONES) 
+        return getOverlay().query(csr, start, end, path);
+        if (matrixUsable()) 
+        return matrixRoute(start, end, path);
+        
+        ensureScratch();
+        return runDijkstra(start, end, path, -1);
+    }
+    
+    // Length of the shortest open road directly joining u and v, or -1 if there is none
+    int roadWeight(int u, int v) 
+    {
+        int best = -1;
+        const RoadNetworkCSR& g = getCSR();
+        for (int a = g.arcBegin(u); a < g.arcEnd(u); a++) 
+        {
+            if (g.dest[a] == v && !g.isBlocked(a) && (best == -1 || g.weight[a] < best)) 
+            best = g.weight[a];
+        }
+        return best;
+    }
+    
+    // Simulated minutes to drive 'path' when leaving its first city at 'departMinute',
+    // following each road's traffic profile. -1 if the path uses a closed road.
+    int routeTravelMinutes(const IntArrayList& path, long long departMinute) 
+    {
+        const RoadNetworkCSR& g = getCSR();
+        const TrafficProfiles& traffic = trafficProfiles();
+        int elapsed = 0;
+        for (int i = 0; i + 1 < path.size(); i++) 
+        {
+            int u = path.get(i), v = path.get(i + 1);
+            int slot = roadIndex.get(u, v);
+            if (slot == -1) 
+            return -1;
+            int a = g.arcBegin(u) + slot;
+            if (g.isBlocked(a)) 
+            return -1;
+            elapsed += traffic.delay(g.profile[a], g.weight[a], departMinute + elapsed);
+        }
+        return elapsed;
+    }
+    
+    // Time-dependent Dijkstra: fastest route for a departure at 'departMinute'. Labels are
+    // elapsed minutes; every relaxation evaluates the road's profile at the label's time.
+    // Profiles are FIFO (see TrafficProfiles::delay), so settling in label order is exact.
+    // Returns travel minutes, or -1 if end is unreachable.
+    int fastestPath(int start, int end, long long departMinute, IntArrayList& path) 
+    {
+        path.clear();
+        if (start < 0 || start >= cityCount || end < 0 || end >= cityCount) 
+        return -1;
+        ensureScratch();
+        
+        int* dist = distBuf;
+        int* parent = parentBuf;
+        for (int i = 0; i < cityCount; i++) 
+        { 
+            dist[i] = INT_MAX; 
+            parent[i] = -1; 
+        }
+        
+        const RoadNetworkCSR& g = getCSR();
+        const TrafficProfiles& traffic = trafficProfiles();
+        MinDistHeap pq;
+        dist[start] = 0;
+        pq.push(start, 0);
+        
+        while (!pq.isEmpty()) 
+        {
+            HeapNode top = pq.pop();
+            int u = top.vertex;
+            if (top.dist > dist[u]) 
+            continue;
+            if (u == end) 
+            break;
+            
+            for (int a = g.arcBegin(u); a < g.arcEnd(u); a++) 
+            {
+                if (g.isBlocked(a)) 
+                continue;
+                int v = g.dest[a];
+                int nd = top.dist + traffic.delay(g.profile[a], g.weight[a], departMinute + top.dist);
+                if (nd < dist[v]) 
+                {
+                    dist[v] = nd;
+                    parent[v] = u;
+                    pq.push(v, nd);
+                }
+            }
+        }
+        
+        if (dist[end] == INT_MAX) 
+        return -1;
+        
+        for (int v = end; v != -1; v = parent[v]) 
+        path.add(v);
+        path.reverse();
+        return dist[end];
+    }
+    
+    // Yen's algorithm: the k shortest loopless routes from start to end, in increasing distance.
+    // Each round only runs one Dijkstra per spur node of the previous route.
+    // Returns the number of routes written to paths[] / dists[].
+    int findKShortestPaths(int start, int end, int k, IntArrayList* paths, int* dists) 
+    {
+        if (k <= 0) 
+        return 0;
+        
+        IntArrayList first;
+        int firstDist = routeFromHub(start, end, first);
+        if (firstDist == -1) 
+        return 0;
+        
+        ensureScratch();
+        paths[0] = first; 
+        dists[0] = firstDist;
+        int found = 1;
+        
+        PathList candidates;
+        IntArrayList spurPath;
+        
+        while (found < k) 
+        {
+            IntArrayList& prev = paths[found - 1];
+            int rootDist = 0;
+            
+            for (int i = 0; i < prev.size() - 1; i++) 
+            {
+                int spur = prev.get(i);
+                
+                // Ban the next hop of every accepted route sharing this root
+                for (int r = 0; r < found; r++) 
+                {
+                    IntArrayList& accepted = paths[r];
+                    if (accepted.size() <= i + 1) 
+                    continue;
+                    
+                    bool sameRoot = true;
+                    for (int j = 0; j <= i && sameRoot; j++) 
+                    if (accepted.get(j) != prev.get(j)) 
+                    sameRoot = false;
+                    
+                    if (sameRoot) 
+                    bannedNextBuf[accepted.get(i + 1)] = true;
+                }
+                
+                // Root cities (except the spur itself) may not be revisited
+                for (int j = 0; j < i; j++) 
+                bannedNodeBuf[prev.get(j)] = true;
+                
+                int spurDist = runDijkstra(spur, end, spurPath, spur);
+                
+                if (spurDist != -1) 
+                {
+                    IntArrayList candidate;
+                    for (int j = 0; j < i; j++) 
+                    candidate.add(prev.get(j));
+                    for (int j = 0; j < spurPath.size(); j++) 
+                    candidate.add(spurPath.get(j));
+                    
+                    if (!candidates.contains(candidate)) 
+                    candidates.add(candidate, rootDist + spurDist);
+                }
+                
+                // Reset bans for the next spur node
+                for (int j = 0; j < i; j++) 
+                bannedNodeBuf[prev.get(j)] = false;
+                for (int r = 0; r < found; r++) 
+                if (paths[r].size() > i + 1) 
+                bannedNextBuf[paths[r].get(i + 1)] = false;
+                
+                rootDist += roadWeight(spur, prev.get(i + 1));
+            }
+            
+            int best = candidates.minIndex();
+            if (best == -1) 
+            break; // No more alternatives exist
+            
+            paths[found] = candidates.getPath(best);
+            dists[found] = candidates.getDist(best);
+            candidates.removeAt(best);
+            found++;
+        }
+        return found;
+    }
+
+    // Fills availablePaths with up to MAX_ROUTE_OPTIONS best routes (index 0 is the shortest)
+    void findAllPaths(int start, int end) 
+    {
+        pathCount = findKShortestPaths(start, end, MAX_ROUTE_OPTIONS, availablePaths, availablePathDistances);
+    }
+    
+    // Append a route to the displayed options unless it is already listed. When the list is
+    // full the route takes the place of option 'evict' (if given). Returns its index, or -1.
+    int addRouteOption(const IntArrayList& path, int dist, int evict = -1) 
+    {
+        for (int i = 0; i < pathCount; i++) 
+        {
+            IntArrayList& other = availablePaths[i];
+            bool same = (other.size() == path.size());
+            for (int j = 0; same && j < path.size(); j++) 
+            same = (other.get(j) == path.get(j));
+            if (same) 
+            return i;
+        }
+        if (pathCount >= MAX_ROUTE_OPTIONS) 
+        {
+            if (evict < 0 || evict >= pathCount) 
+            return -1;
+            availablePaths[evict] = path;
+            availablePathDistances[evict] = dist;
+            return evict;
+        }
+        availablePaths[pathCount] = path;
+        availablePathDistances[pathCount] = dist;
+        return pathCount++;
+    }
+    
+    int getMinRouteIndex() 
+    {
+        int minIdx = -1;
+        int minDist = INT_MAX;
+        for(int i=0; i<pathCount; i++) 
+        {
+            if(availablePathDistances[i] < minDist) 
+            {
+                minDist = availablePathDistances[i];
+                minIdx = i;
+            }
+        }
+        return minIdx;
+    }
+    
+    // Toggle Road Block Status in O(1) via the road index.
+    // Returns false if there is no road between u and v.
+    bool setRoadStatus(int u, int v, bool blocked) 
+    {
+        int slotUV = roadIndex.get(u, v);
+        int slotVU = roadIndex.get(v, u);
+        if (slotUV == -1 || slotVU == -1) 
+        return false;
+        
+        if (cities[u].edges.getRef(slotUV).isBlocked == blocked) 
+        return true; // Nothing changes
+        
+        // Block edges in both directions (undirected graph)
+        cities[u].edges.getRef(slotUV).isBlocked = blocked;
+        cities[v].edges.getRef(slotVU).isBlocked = blocked;
+        patchBlocked(u, slotUV, blocked);
+        patchBlocked(v, slotVU, blocked);
+        if (overlay.structureEpoch == structureEpoch) 
+        overlay.roadChanged(u, v);
+        
+        // Incremental tree repair: closing a road that no fresh hub tree uses cannot change
+        // any of its shortest paths, so those trees stay valid across the epoch bump.
+        unsigned long before = graphEpoch++;
+        if (!blocked && matrix.builtEpoch == before) 
+        {
+            // A reopened road only gets cheaper: fold it into the matrix instead of recomputing
+            matrix.roadCheaper(u, v, cities[u].edges.getRef(slotUV).weight);
+            matrix.builtEpoch = graphEpoch;
+        }
+        if (blocked) 
+        {
+            for (int i = 0; i < treeCount; i++) 
+            {
+                ShortestPathTree* tree = trees[i];
+                if (tree->builtEpoch == before && tree->parent[v] != u && tree->parent[u] != v) 
+                tree->builtEpoch = graphEpoch;
+            }
+        }
+        return true;
+    }
+    
+    void printGraph() 
+    {
+        for (int i = 0; i < cityCount; i++) 
+        {
+            cout << " [" << i << "] " << cities[i].name << " (" << cities[i].zone << ") -> ";
+            EdgeArrayList& edges = cities[i].edges;
+            for (int j = 0; j < edges.size(); j++) 
+            {
+                Edge e = edges.getRef(j);
+                cout << cities[e.dest].name << "(" << e.weight << "km)" << (e.isBlocked ? "[BLOCKED] " : " ");
+            }
+            cout << endl;
+        }
+    }
+    
+    void saveToFile(ofstream& out) 
+    {
+        out << cityCount << endl;
+        for(int i=0; i<cityCount; i++) 
+        {
+            out << cities[i].name << "," << cities[i].zone << endl;
+        }
+        
+        for(int i=0; i<cityCount; i++) 
+        {
+            EdgeArrayList& edges = cities[i].edges;
+            for(int j=0; j<edges.size(); j++) 
+            {
+                Edge& e = edges.getRef(j);
+                if (i < e.dest) // Store each road only once
+                { 
+                     out << cities[i].name << "," << cities[e.dest].name << "," << e.weight << endl;
+                }
+            }
+        }
+    }
+};
+
+struct User 
+{
+    string username;
+    string password;
+    string role; // "ADMIN" or "CUSTOMER"
+    
+    User(string u="", string p="", string r="CUSTOMER") : username(u), password(p), role(r) {}
+};
+
+struct UserEntry 
+{ 
+    string key; 
+    User* value; 
+    bool occupied; 
+    UserEntry() : key(""), value(nullptr), occupied(false) {} 
+};
+
+class UserHashTable 
+{
+private:
+    UserEntry* table; 
+    int capacity;
+    
+    int hashFunction(const string& key) 
+    {
+        unsigned long hash = 5381;
+        for (char c : key) hash = ((hash << 5) + hash) + c; 
+        return hash % capacity;
+    }
+
+public:
+    UserHashTable(int cap = 101) : capacity(cap) 
+    { 
+        table = new UserEntry[capacity]; 
+    }
+    
+    ~UserHashTable() 
+    {
+        // Delete all User objects before deleting table
+        for(int i=0; i<capacity; i++) 
+        {
+            if(table[i].occupied && table[i].value) 
+            {
+                delete table[i].value;
+            }
+        }
+        delete[] table; 
+    }
+    
+    void insert(string username, User* user) 
+    {
+        int index = hashFunction(username); int i = 0;
+        while (i < capacity) 
+        {
+            int probe = (index + i * i) % capacity;
+            if (!table[probe].occupied || table[probe].key == username) 
+            {
+                table[probe].key = username; table[probe].value = user; table[probe].occupied = true; return;
+            }
+            i++;
+        }
+    }
+    
+    User* search(string username) 
+    {
+        int index = hashFunction(username); int i = 0;
+        while (i < capacity) 
+        {
+            int probe = (index + i * i) % capacity;
+            if (!table[probe].occupied) return nullptr;
+            if (table[probe].key == username) return table[probe].value;
+            i++;
+        }
+        return nullptr;
+    }
+    
+    void saveToFile(ofstream& out) 
+    {
+         for(int i=0; i<capacity; i++) 
+         {
+             if(table[i].occupied) 
+             {
+                 User* u = table[i].value;
+                 out << u->username << "," << u->password << "," << u->role << endl;
+             }
+         }
+    }
+};
+
+
+struct UndoAction 
+{ 
+    string type; 
+    ParcelHandle parcel; 
+};
+
+struct UndoNode 
+{ 
+    UndoAction data; 
+    UndoNode* next; 
+    UndoNode(UndoAction d) : data(d), next(nullptr) {} 
+};
+
+class ActionStack 
+{
+private:
+    UndoNode* topNode;
+
+public:
+
+    ActionStack() : topNode(nullptr) {}
+    
+    void push(string type, ParcelHandle parcel) 
+    { 
+        UndoNode* n = new UndoNode({type, parcel}); 
+        n->next = topNode; 
+        topNode = n; 
+    }
+    
+    bool pop(UndoAction& dest) 
+    {
+        if(!topNode) 
+        return false;
+        
+        UndoNode* temp = topNode; 
+        dest = temp->data; 
+        topNode = topNode->next; 
+        delete temp; 
+        
+        return true;
+    }
+};
+
+// One hub's waiting parcels, split into a sorting queue per destination zone shard so that
+// each zone can be drained by its own dispatch worker. Hub-wide operations choose across the
+// shards (there are only a handful of zones).
+class HubQueue 
+{
+private:
+    SortingQueue** shards; 
+    int count; 
+    int capacity;
+    int kind;
+    
+    static int shardOf(Parcel* p) 
+    {
+        return p->shard < 0 ? 0 : p->shard;
+    }
+    
+    // Shard holding the most urgent parcel, -1 if the hub is empty
+    int topShard() 
+    {
+        int best = -1;
+        for (int s = 0; s < count; s++) 
+        {
+            Parcel* top = shards[s]->peekMax();
+            if (top && (best == -1 || SortingQueue::outranks(kind, top, shards[best]->peekMax()))) 
+            best = s;
+        }
+        return best;
+    }
+
+public:
+    HubQueue(int queueKind) : count(0), capacity(4), kind(queueKind) 
+    {
+        shards = new SortingQueue*[capacity];
+    }
+    
+    ~HubQueue() 
+    {
+        for (int i = 0; i < count; i++) 
+        delete shards[i];
+        delete[] shards;
+    }
+    
+    // Queue of zone shard 's', created on first use
+    SortingQueue& shard(int s) 
+    {
+        while (count <= s) 
+        {
+            if (count == capacity) 
+            {
+                SortingQueue** newShards = new SortingQueue*[capacity * 2];
+                for (int i = 0; i < count; i++) 
+                newShards[i] = shards[i];
+                delete[] shards; 
+                shards = newShards; 
+                capacity *= 2;
+            }
+            shards[count++] = new SortingQueue(kind);
+        }
+        return *shards[s];
+    }
+    
+    // Never creates a queue, so dispatch workers may call it: nullptr if 's' never had parcels
+    SortingQueue* findShard(int s) 
+    {
+        return (s >= 0 && s < count) ? shards[s] : nullptr;
+    }
+    
+    void insert(Parcel* p) { shard(shardOf(p)).insert(p); }
+    bool remove(Parcel* p) { return shardOf(p) < count && shards[shardOf(p)]->remove(p); }
+    void update(Parcel* p) { if (shardOf(p) < count) shards[shardOf(p)]->update(p); }
+    
+    Parcel* extractMax() 
+    {
+        int s = topShard();
+        return s == -1 ? nullptr : shards[s]->extractMax();
+    }
+    
+    Parcel* peekMax() 
+    {
+        int s = topShard();
+        return s == -1 ? nullptr : shards[s]->peekMax();
+    }
+    
+    int size() 
+    {
+        int total = 0;
+        for (int i = 0; i < count; i++) 
+        total += shards[i]->size();
+        return total;
+    }
+    
+    bool isEmpty() 
+    {
+        return topShard() == -1;
+    }
+};
+
+// One sorting queue per warehouse hub, indexed by hub slot. Hubs dispatch independently:
+// each drains its own queue and routes from its own cached shortest-path tree.
+class HubQueueSet 
+{
+private:
+    HubQueue** queues; 
+    int count; 
+    int capacity;
+    int kind;       // QUEUE_KIND_* used for every hub queue
+
+public:
+    HubQueueSet(int queueKind = QUEUE_KIND_HEAP) : count(0), capacity(4), kind(queueKind) 
+    {
+        queues = new HubQueue*[capacity];
+    }
+    
+    ~HubQueueSet() 
+    {
+        for (int i = 0; i < count; i++) 
+        delete queues[i];
+        delete[] queues;
+    }
+    
+    // Queue of hub 'slot', created on first use
+    HubQueue& at(int slot) 
+    {
+        while (count <= slot) 
+        {
+            if (count == capacity) 
+            {
+                HubQueue** newQueues = new HubQueue*[capacity * 2];
+                for (int i = 0; i < count; i++) 
+                newQueues[i] = queues[i];
+                delete[] queues; 
+                queues = newQueues; 
+                capacity *= 2;
+            }
+            queues[count++] = new HubQueue(kind);
+        }
+        return *queues[slot];
+    }
+    
+    int size() const 
+    { 
+        return count; 
+    }
+    
+    int getKind() const 
+    {
+        return kind;
+    }
+    
+    // Switch every hub queue to another implementation, moving the waiting parcels across
+    void setKind(int newKind) 
+    {
+        if (newKind == kind) 
+        return;
+        kind = newKind;
+        for (int h = 0; h < count; h++) 
+        {
+            HubQueue* fresh = new HubQueue(kind);
+            while (!queues[h]->isEmpty()) 
+            fresh->insert(queues[h]->extractMax());
+            delete queues[h];
+            queues[h] = fresh;
+        }
+    }
+    
+    bool outranks(Parcel* a, Parcel* b) const 
+    {
+        return SortingQueue::outranks(kind, a, b);
+    }
+};
+
+// Heaviest first, in place (heapsort on weight): the ordering First-Fit Decreasing needs
+void sortByWeightDesc(ParcelArrayList& list) 
+{
+    int n = list.size();
+    // Build a min-heap on weight, then repeatedly move the lightest to the back
+    for (int start = n / 2 - 1; start >= 0; start--) 
+    {
+        for (int i = start; 2 * i + 1 < n; ) 
+        {
+            int c = 2 * i + 1;
+            if (c + 1 < n && list.get(c + 1)->weight < list.get(c)->weight) c++;
+            if (list.get(i)->weight <= list.get(c)->weight) break;
+            list.swap(i, c); 
+            i = c;
+        }
+    }
+    for (int end = n - 1; end > 0; end--) 
+    {
+        list.swap(0, end);
+        for (int i = 0; 2 * i + 1 < end; ) 
+        {
+            int c = 2 * i + 1;
+            if (c + 1 < end && list.get(c + 1)->weight < list.get(c)->weight) c++;
+            if (list.get(i)->weight <= list.get(c)->weight) break;
+            list.swap(i, c); 
+            i = c;
+        }
+    }
+}
+
+// ---------------------------------------------------------
+// RIDER TOUR OPTIMIZER
+// ---------------------------------------------------------
+// A tour leaves the hub (table row 0), visits every stop once and ends at the last stop.
+// It only reads its own distance table, so the tours of different riders can be improved
+// on separate threads while the map stays untouched.
+const int TOUR_UNREACHABLE = INT_MAX / 4;   // Table entry for a stop with no road to it
+const double TOUR_BUDGET_MS = 20;           // Local search time allowed per tour
+
+struct TourJob 
+{
+    int n;                  // Hub + stops
+    const int* dist;        // n x n road km
+    int* order;             // Out: order[0] = 0 (hub), then the stops in visiting order
+    long long greedyLength; // Nearest-neighbour tour, before local search
+    long long length;       // Final tour
+
+    TourJob() : n(0), dist(nullptr), order(nullptr), greedyLength(0), length(0) {}
+};
+
+class TourOptimizer 
+{
+    // Shared by the worker threads of optimizeAll
+    struct WorkQueue 
+    {
+        TourJob** jobs;
+        int count;
+        double budgetMs;
+        std::atomic<int> next;
+    };
+
+    static int d(const TourJob& job, int a, int b) 
+    {
+        return job.dist[job.order[a] * job.n + job.order[b]];
+    }
+
+    static void nearestNeighbour(TourJob& job) 
+    {
+        int n = job.n;
+        for (int i = 0; i < n; i++) job.order[i] = i;
+        for (int i = 1; i < n; i++) 
+        {
+            int best = i;
+            for (int j = i + 1; j < n; j++) 
+            if (d(job, i - 1, j) < d(job, i - 1, best)) best = j;
+            int t = job.order[i]; job.order[i] = job.order[best]; job.order[best] = t;
+        }
+    }
+
+    // Reverse order[i..j] when it shortens the tour (distances are symmetric: roads are two-way) 
+    static bool twoOptPass(TourJob& job) 
+    {
+        int n = job.n;
+        bool improved = false;
+        for (int i = 1; i < n - 1; i++) 
+        for (int j = i + 1; j < n; j++) 
+        {
+            long long delta = (long long)d(job, i - 1, j) - d(job, i - 1, i);
+            if (j + 1 < n) delta += (long long)d(job, i, j + 1) - d(job, j, j + 1);
+            if (delta >= 0) continue;
+            for (int a = i, b = j; a < b; a++, b--) 
+            {
+                int t = job.order[a]; job.order[a] = job.order[b]; job.order[b] = t;
+            }
+            improved = true;
+        }
+        return improved;
+    }
+
+    // Move a run of 1-3 consecutive stops to the cheapest other place in the tour
+    static bool orOptPass(TourJob& job, int* scratch) 
+    {
+        int n = job.n;
+        bool improved = false;
+        for (int len = 1; len <= 3; len++) 
+        for (int i = 1; i + len <= n; i++) 
+        {
+            int last = i + len - 1;
+            long long gain = d(job, i - 1, i);
+            if (last + 1 < n) gain += (long long)d(job, last, last + 1) - d(job, i - 1, last + 1);
+
+            int bestAfter = -1;
+            long long bestCost = gain;
+            for (int q = 0; q < n; q++) 
+            {
+                if (q >= i - 1 && q <= last) continue;
+                long long cost = d(job, q, i);
+                if (q + 1 < n) cost += (long long)d(job, last, q + 1) - d(job, q, q + 1);
+                if (cost < bestCost) { bestCost = cost; bestAfter = q; }
+            }
+            if (bestAfter == -1) continue;
+
+            int k = 0;
+            for (int p = 0; p < n; p++) 
+            {
+                if (p >= i && p <= last) continue;
+                scratch[k++] = job.order[p];
+                if (p == bestAfter) 
+                for (int s = i; s <= last; s++) scratch[k++] = job.order[s];
+            }
+            for (int p = 0; p < n; p++) job.order[p] = scratch[p];
+            improved = true;
+        }
+        return improved;
+    }
+
+    static void worker(WorkQueue* q) 
+    {
+        for (int i = q->next++; i < q->count; i = q->next++) 
+        optimize(*q->jobs[i], q->budgetMs);
+    }
+
+public:
+    static long long length(const TourJob& job) 
+    {
+        long long total = 0;
+        for (int i = 1; i < job.n; i++) total += d(job, i - 1, i);
+        return total;
+    }
+
+    // Nearest-neighbour start, then 2-opt and Or-opt passes until neither helps or the budget is spent
+    static void optimize(TourJob& job, double budgetMs) 
+    {
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        nearestNeighbour(job);
+        job.greedyLength = job.length = length(job);
+        if (job.n < 3) 
+        return;
+
+        int* scratch = new int[job.n];
+        bool improved = true;
+        while (improved) 
+        {
+            std::chrono::duration<double, std::milli> spent = std::chrono::steady_clock::now() - t0;
+            if (spent.count() >= budgetMs) 
+            break;
+            improved = twoOptPass(job);
+            if (orOptPass(job, scratch)) improved = true;
+        }
+        delete[] scratch;
+        job.length = length(job);
+    }
+
+    // Optimize independent tours on all cores
+    static void optimizeAll(TourJob** jobs, int count, double budgetMs) 
+    {
+        int threads = (int)std::thread::hardware_concurrency();
+        if (threads > count) threads = count;
+        if (threads <= 1) 
+        {
+            for (int i = 0; i < count; i++) optimize(*jobs[i], budgetMs);
+            return;
+        }
+
+        WorkQueue q;
+        q.jobs = jobs;
+        q.count = count;
+        q.budgetMs = budgetMs;
+        q.next = 0;
+        std::thread* pool = new std::thread[threads - 1];
+        for (int t = 0; t < threads - 1; t++) pool[t] = std::thread(worker, &q);
+        worker(&q);
+        for (int t = 0; t < threads - 1; t++) pool[t].join();
+        delete[] pool;
+    }
+};
+
+// One consolidated rider trip being packed
+struct TripBin 
+{
+    Rider* rider;
+    int hub;
+    double load;            // kg packed so far
+    ParcelArrayList parcels;
+    IntArrayList stops;     // Distinct destination cities
+    int* dist;              // (stops + 1)^2 km table, hub first
+    TourJob tour;           // Visiting order over hub + stops
+    
+    TripBin() : rider(nullptr), hub(-1), load(0), dist(nullptr) {}
+    ~TripBin() 
+    { 
+        delete[] dist; 
+        delete[] tour.order; 
+    }
+};
+
+// Outcome of one consolidation run
+struct ConsolidationSummary 
+{
+    int parcels;            // Parcels sent out
+    int trips;              // Rider trips used for them
+    int heldBack;           // Left waiting (no idle rider)
+    long long greedyKm;     // Total tour km with nearest-neighbour order
+    long long tourKm;       // ... after 2-opt / Or-opt
+    double tourMs;          // Wall time spent planning tours
+    
+    ConsolidationSummary() : parcels(0), trips(0), heldBack(0), greedyKm(0), tourKm(0), tourMs(0) {}
+};
+
+// Dispatches that left their hub before / after the SLA deadline, per priority (1..3)
+struct SlaStats 
+{
+    int onTime[4]; 
+    int late[4];
+    
+    SlaStats() 
+    {
+        for (int i = 0; i < 4; i++) 
+        { 
+            onTime[i] = 0; 
+            late[i] = 0; 
+        }
+    }
+    
+    // Returns true if the dispatch missed its deadline
+    bool record(Parcel* p, long long now) 
+    {
+        int level = p->priority < 1 ? 1 : (p->priority > 3 ? 3 : p->priority);
+        bool missed = now > p->slaDeadline;
+        if (missed) late[level]++; 
+        else onTime[level]++;
+        return missed;
+    }
+};
+
+// Outcome of one non-interactive dispatch run
+struct BatchDispatchSummary 
+{
+    int dispatched; 
+    int returned;       // No route from the hub: returned to sender
+    int remaining;      // Still waiting in hub queues afterwards
+    int late;           // Dispatched after their SLA deadline
+    bool fleetFull;     // Stopped because no suitable rider was free
+    bool outOfTime;     // Stopped by the time budget
+    double elapsedMs;
+    int workers;        // Dispatch threads used
+    int stolen;         // Parcels taken from another zone's queue by an idle zone
+    
+    BatchDispatchSummary() : dispatched(0), returned(0), remaining(0), late(0), fleetFull(false), outOfTime(false), 
+                             elapsedMs(0), workers(1), stolen(0) {}
+};
+
+// State of one zone shard's dispatch worker. The lock guards the shard's hub queues, which
+// other workers may steal from; the rider pool shard is only ever touched by its own worker.
+struct ShardWorker 
+{
+    int shard;
+    std::mutex lock;
+    ParcelArrayList loaded;     // Given a rider and a route, published once the workers join
+    IntArrayList loadedEta;     // Travel minutes of each loaded parcel
+    ParcelArrayList noRoute;    // Unreachable from their hub
+    int stolen;
+    bool fleetFull;
+    bool outOfTime;
+    
+    ShardWorker() : shard(0), stolen(0), fleetFull(false), outOfTime(false) {}
+};
+
+// Reverse index road -> parcels whose dispatched route uses it, so a closure only touches
+// the parcels it can affect. Entries are validated on read (parcels that were delivered or
+// rerouted since are dropped), and each bucket sweeps stale entries as it doubles in size.
+class RoadParcelIndex 
+{
+private:
+    PairIndex slots;            // (min city, max city) -> bucket
+    ParcelArrayList** buckets; 
+    int* sweepAt;               // Bucket size that triggers the next stale sweep
+    int count; 
+    int capacity;
+
+public:
+    RoadParcelIndex() : count(0), capacity(16) 
+    {
+        buckets = new ParcelArrayList*[capacity];
+        sweepAt = new int[capacity];
+    }
+    
+    ~RoadParcelIndex() 
+    {
+        for (int i = 0; i < count; i++) 
+        delete buckets[i];
+        delete[] buckets; 
+        delete[] sweepAt;
+    }
+    
+    static bool isInFlight(Parcel* p) 
+    {
+        return p->status == STATUS_LOADING || p->status == STATUS_IN_TRANSIT;
+    }
+    
+    void add(int u, int v, Parcel* p) 
+    {
+        if (u > v) { int t = u; u = v; v = t; }
+        int b = slots.get(u, v);
+        if (b == -1) 
+        {
+            if (count == capacity) 
+            {
+                ParcelArrayList** newBuckets = new ParcelArrayList*[capacity * 2];
+                int* newSweep = new int[capacity * 2];
+                for (int i = 0; i < count; i++) 
+                { 
+                    newBuckets[i] = buckets[i]; 
+                    newSweep[i] = sweepAt[i]; 
+                }
+                delete[] buckets; delete[] sweepAt;
+                buckets = newBuckets; sweepAt = newSweep; 
+                capacity *= 2;
+            }
+            b = count++;
+            buckets[b] = new ParcelArrayList();
+            sweepAt[b] = 16;
+            slots.put(u, v, b);
+        }
+        
+        ParcelArrayList* list = buckets[b];
+        list->add(p);
+        if (list->size() >= sweepAt[b]) 
+        {
+            for (int i = list->size() - 1; i >= 0; i--) 
+            if (!isInFlight(list->get(i))) 
+            list->removeAt(i);
+            sweepAt[b] = list->size() * 2 > 16 ? list->size() * 2 : 16;
+        }
+    }
+    
+    // Parcels registered on road (u,v), or nullptr
+    ParcelArrayList* get(int u, int v) 
+    {
+        if (u > v) { int t = u; u = v; v = t; }
+        int b = slots.get(u, v);
+        return b == -1 ? nullptr : buckets[b];
+    }
+};
+
+// Milliseconds elapsed since 'start' (CPU clock)
+double elapsedMs(clock_t start) 
+{
+    return (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+// Compare point-to-point query latency of plain Dijkstra against the contraction hierarchy
+// and the zone overlay on a synthetic side x side grid network (with a few diagonal highways),
+// split into 4 x 4 square zones.
+void benchmarkRouting(int side, int queries) 
+{
+    MapGraph grid;
+    int n = side * side;
+    int block = (side + 3) / 4;
+    for (int i = 0; i < n; i++) 
+    grid.addCity("J" + to_string(i), "Zone " + to_string(((i / side) / block) * 4 + (i % side) / block));
+    
+    for (int r = 0; r < side; r++) 
+    {
+        for (int c = 0; c < side; c++) 
+        {
+            int u = r * side + c;
+            if (c + 1 < side) grid.addRoad(u, u + 1, 5 + rand() % 96);
+            if (r + 1 < side) grid.addRoad(u, u + side, 5 + rand() % 96);
+            if (c + 1 < side && r + 1 < side && rand() % 10 == 0) grid.addRoad(u, u + side + 1, 5 + rand() % 96);
+        }
+    }
+    
+    cout << "\n[ ROUTING BENCHMARK ] " << n << " junctions, " << queries << " random queries\n";
+    
+    clock_t t0 = clock();
+    grid.setRoutingEngine(ROUTE_ENGINE_CH);
+    ContractionHierarchy& ch = grid.getCH();
+    double prepMs = elapsedMs(t0);
+    cout << "  CH preprocessing:       " << fixed << setprecision(1) << prepMs << " ms (" << ch.getShortcutCount() << " upward arcs)\n";
+    
+    t0 = clock();
+    ZoneOverlay& overlay = grid.getOverlay();
+    cout << "  Overlay preprocessing:  " << elapsedMs(t0) << " ms (" << overlay.getZoneCount() << " zones, " 
+         << overlay.getBoundaryCount() << " boundary junctions)\n";
+    
+    int closedU, closedV;
+    grid.blockRandomRoad(closedU, closedV);
+    t0 = clock();
+    grid.getCH();
+    cout << "  CH re-customization:    " << elapsedMs(t0) << " ms (after one road closure)\n";
+    t0 = clock();
+    grid.getOverlay();
+    cout << "  Overlay zone refresh:   " << elapsedMs(t0) << " ms (after one road closure)\n";
+    
+    int* src = new int[queries];
+    int* dst = new int[queries];
+    int* expected = new int[queries];
+    for (int q = 0; q < queries; q++) 
+    {
+        src[q] = rand() % n; 
+        dst[q] = rand() % n;
+    }
+    
+    IntArrayList path;
+    grid.setRoutingEngine(ROUTE_ENGINE_DIJKSTRA);
+    t0 = clock();
+    for (int q = 0; q < queries; q++) 
+    expected[q] = grid.shortestPath(src[q], dst[q], path);
+    double dijkstraMs = elapsedMs(t0);
+    
+    grid.setRoutingEngine(ROUTE_ENGINE_CH);
+    int mismatches = 0;
+    t0 = clock();
+    for (int q = 0; q < queries; q++) 
+    if (grid.shortestPath(src[q], dst[q], path) != expected[q]) 
+    mismatches++;
+    double chMs = elapsedMs(t0);
+    
+    grid.setRoutingEngine(ROUTE_ENGINE_ZONES);
+    t0 = clock();
+    for (int q = 0; q < queries; q++) 
+    if (grid.shortestPath(src[q], dst[q], path) != expected[q]) 
+    mismatches++;
+    double zoneMs = elapsedMs(t0);
+    
+    cout << "  Dijkstra:               " << setprecision(3) << dijkstraMs / queries << " ms/query\n";
+    cout << "  Contraction hierarchy:  " << chMs / queries << " ms/query";
+    if (chMs > 0) cout << "  (" << setprecision(1) << dijkstraMs / chMs << "x faster)";
+    cout << "\n  Zone overlay:           " << setprecision(3) << zoneMs / queries << " ms/query";
+    if (zoneMs > 0) cout << "  (" << setprecision(1) << dijkstraMs / zoneMs << "x faster)";
+    cout << "\n  Distance mismatches:    " << mismatches << "\n";
+    cout.unsetf(ios::fixed); 
+    cout << setprecision(6);
+    
+    delete[] src; delete[] dst; delete[] expected;
+}
+
+void benchmarkMatrix(int n) 
+{
+    MapGraph net;
+    for (int i = 0; i < n; i++) 
+    net.addCity("M" + to_string(i), "Zone 1");
+    
+    // Sparse road network: a random spanning chain plus extra random roads
+    for (int i = 1; i < n; i++) 
+    net.addRoad(i, rand() % i, 5 + rand() % 96);
+    for (int i = 0; i < 2 * n; i++) 
+    net.addRoad(rand() % n, rand() % n, 5 + rand() % 96);
+    
+    cout << "\n[ DISTANCE MATRIX BENCHMARK ] " << n << " cities";
+#ifdef __AVX2__
+    cout << " (AVX2 kernel)\n";
+#else
+    cout << " (scalar kernel)\n";
+#endif
+    
+    net.setRoutingEngine(ROUTE_ENGINE_MATRIX);
+    clock_t t0 = clock();
+    net.getMatrix();
+    cout << "  Blocked Floyd-Warshall: " << fixed << setprecision(1) << elapsedMs(t0) << " ms\n";
     
-    // Toggle Road Block Status
-    void setRoadStatus(int u, int v, bool blocked) 
+    // Close a road (full recompute), then reopen it (incremental update)
+    int u, v;
+    net.blockRandomRoad(u, v);
+    t0 = clock();
+    net.getMatrix();
+    cout << "  Recompute after closure: " << elapsedMs(t0) << " ms\n";
+    t0 = clock();
+    net.setRoadStatus(u, v, false);
+    net.getMatrix();
+    cout << "  Incremental reopen:     " << setprecision(3) << elapsedMs(t0) << " ms\n";
+    
+    const int sources = 20;
+    int mismatches = 0;
+    IntArrayList path;
+    net.setRoutingEngine(ROUTE_ENGINE_DIJKSTRA);
+    for (int q = 0; q < sources; q++) 
     {
-        // Block edges in both directions (undirected graph)
-        EdgeArrayList& edges1 = cities[u].edges;
-        for(int i=0; i<edges1.size(); i++) 
-        {
-            if(edges1.getRef(i).dest == v) 
-            {
-                edges1.getRef(i).isBlocked = blocked;
-            }
-        }
-        
-        EdgeArrayList& edges2 = cities[v].edges;
-        for(int i=0; i<edges2.size(); i++) 
+        int s = rand() % n;
+        for (int t = 0; t < n; t += 7) 
         {
-            if(edges2.getRef(i).dest == u) 
-            {
-                edges2.getRef(i).isBlocked = blocked;
-            }
+            int expected = net.shortestPath(s, t, path);
+            int stored = net.getMatrix().get(s, t);
+            if (stored != (expected == -1 ? DistanceMatrix::INF : expected)) 
+            mismatches++;
         }
     }
     
-    void printGraph() 
+    net.setRoutingEngine(ROUTE_ENGINE_MATRIX);
+    const int lookups = 1000000;
+    long long checksum = 0;
+    t0 = clock();
+    for (int q = 0; q < lookups; q++) 
+    checksum += net.routeDistance(rand() % n, rand() % n);
+    double lookupMs = elapsedMs(t0);
+    
+    cout << "  Quote lookup:           " << setprecision(1) << lookupMs * 1000000.0 / lookups << " ns/quote (checksum " << checksum << ")\n";
+    cout << "  Mismatches vs Dijkstra: " << mismatches << "\n";
+    cout.unsetf(ios::fixed); 
+    cout << setprecision(6);
+}
+
+// Insert n parcels, then drain: indexed 4-ary heap vs bucket queue
+void benchmarkSortingQueues(int n) 
+{
+    cout << "\n[ SORTING QUEUE BENCHMARK ] " << n << " queued parcels\n";
+    Parcel* parcels = new Parcel[n];
+    for (int i = 0; i < n; i++) 
     {
-        for (int i = 0; i < cityCount; i++) 
-        {
-            cout << " [" << i << "] " << cities[i].name << " (" << cities[i].zone << ") -> ";
-            EdgeArrayList& edges = cities[i].edges;
-            for (int j = 0; j < edges.size(); j++) 
-            {
-                Edge e = edges.getRef(j);
-                cout << cities[e.dest].name << "(" << e.weight << "km)" << (e.isBlocked ? "[BLOCKED] " : " ");
-            }
-            cout << endl;
-        }
+        parcels[i].weight = rand() % 50;
+        parcels[i].setPriority(1 + rand() % 3);
     }
     
-    void saveToFile(ofstream& out) 
+    const char* names[2] = { "Indexed 4-ary heap", "Bucket queue      " };
+    for (int kind = QUEUE_KIND_HEAP; kind <= QUEUE_KIND_BUCKET; kind++) 
     {
-        out << cityCount << endl;
-        for(int i=0; i<cityCount; i++) 
-        {
-            out << cities[i].name << "," << cities[i].zone << endl;
-        }
+        SortingQueue queue(kind);
+        clock_t t0 = clock();
+        for (int i = 0; i < n; i++) 
+        queue.insert(&parcels[i]);
+        double insertMs = elapsedMs(t0);
         
-        for(int i=0; i<cityCount; i++) 
+        int outOfOrder = 0;
+        int last = INT_MAX;
+        t0 = clock();
+        while (!queue.isEmpty()) 
         {
-            EdgeArrayList& edges = cities[i].edges;
-            for(int j=0; j<edges.size(); j++) 
-            {
-                Edge& e = edges.getRef(j);
-                if (i < e.dest) // Store each road only once
-                { 
-                     out << cities[i].name << "," << cities[e.dest].name << "," << e.weight << endl;
-                }
-            }
+            Parcel* p = queue.extractMax();
+            if (p->priorityScore > last) outOfOrder++;
+            last = p->priorityScore;
         }
+        double extractMs = elapsedMs(t0);
+        
+        cout << "  " << names[kind] << "  insert: " << fixed << setprecision(1) << insertMs << " ms   extract-all: " 
+             << extractMs << " ms   out of order: " << outOfOrder << "\n";
     }
-};
+    cout.unsetf(ios::fixed); 
+    cout << setprecision(6);
+    delete[] parcels;
+}
 
-struct User 
+// Stress the parcel database at n entries: insert, look up by ID (hits and misses) and by
+// handle, erase half, then re-insert over the tombstones. Every step is checked; the slowest
+// single insert shows that incremental rehashing keeps resizes from stalling a call.
+void benchmarkParcelTable(int n) 
 {
-    string username;
-    string password;
-    string role; // "ADMIN" or "CUSTOMER"
+    cout << "\n[ PARCEL DATABASE BENCHMARK ] " << n << " entries\n";
+    ParcelHashTable table(1024, 0.7, false);
+    Parcel dummy;
+    int errors = 0;
+    double worstInsertUs = 0;
     
-    User(string u="", string p="", string r="CUSTOMER") : username(u), password(p), role(r) {}
-};
+    clock_t t0 = clock();
+    for (int i = 0; i < n; i++) 
+    {
+        std::chrono::steady_clock::time_point s0 = std::chrono::steady_clock::now();
+        table.insert("PK" + to_string(i), &dummy);
+        std::chrono::duration<double, std::micro> took = std::chrono::steady_clock::now() - s0;
+        if (took.count() > worstInsertUs) worstInsertUs = took.count();
+    }
+    double insertMs = elapsedMs(t0);
+    if (table.size() != n) errors++;
+    
+    t0 = clock();
+    for (int i = 0; i < n; i++) 
+    if (table.search("PK" + to_string(i)) != &dummy) errors++;
+    for (int i = 0; i < n / 2; i++) 
+    if (table.search("MISS" + to_string(i))) errors++;
+    double searchMs = elapsedMs(t0);
+    
+    t0 = clock();
+    for (int i = 0; i < n; i++) 
+    if (table.get((ParcelHandle)i) != &dummy) errors++;   // Handles are issued densely from 0
+    double getMs = elapsedMs(t0);
+    
+    t0 = clock();
+    for (int i = 0; i < n; i += 2) 
+    if (!table.erase("PK" + to_string(i))) errors++;
+    double eraseMs = elapsedMs(t0);
+    for (int i = 0; i < n; i++) 
+    if ((table.search("PK" + to_string(i)) != nullptr) != (i % 2 == 1)) errors++;
+    
+    t0 = clock();
+    for (int i = 0; i < n; i += 2) 
+    table.insert("PK" + to_string(i), &dummy);
+    double reinsertMs = elapsedMs(t0);
+    if (table.size() != n) errors++;
+    if (table.getRecordCount() != n) errors++;  // The re-inserted IDs took the erased records
+    
+    int lookups = n + n / 2;
+    cout << fixed << setprecision(1);
+    cout << "  Insert:      " << insertMs << " ms (" << (n > 0 ? insertMs * 1e6 / n : 0) << " ns/op, slowest single insert " 
+         << worstInsertUs << " us)\n";
+    cout << "  Search:      " << searchMs << " ms (" << (lookups > 0 ? searchMs * 1e6 / lookups : 0) << " ns/op, 1/3 misses)\n";
+    cout << "  Handle get:  " << getMs << " ms (" << (n > 0 ? getMs * 1e6 / n : 0) << " ns/op)\n";
+    cout << "  Erase half:  " << eraseMs << " ms\n";
+    cout << "  Re-insert:   " << reinsertMs << " ms (" << table.getRecordCount() << " handle records for " 
+         << table.size() << " live IDs)\n";
+    cout << "  Capacity:    " << table.getCapacity() << " slots, load " << setprecision(2) 
+         << (double)table.size() / table.getCapacity() << "\n";
+    cout << "  Check:       " << (errors == 0 ? "OK" : "MISMATCH") << " (" << errors << " errors)\n";
+    cout.unsetf(ios::fixed); 
+    cout << setprecision(6);
+}
 
-struct UserEntry 
+// The parcel database layout before the Swiss table, kept only as a benchmark baseline: a
+// fixed prime-sized table of full entries probed quadratically, comparing keys at every step
+struct ProbeEntry 
 { 
     string key; 
-    User* value; 
-    bool occupied; 
-    UserEntry() : key(""), value(nullptr), occupied(false) {} 
+    Parcel* value; 
 };
 
-class UserHashTable 
+struct QuadraticProbeTable 
 {
-private:
-    UserEntry* table; 
+    ProbeEntry* table;
+    bool* occupied;
     int capacity;
     
-    int hashFunction(const string& key) 
+    QuadraticProbeTable(int cap) : capacity(cap) 
     {
-        unsigned long hash = 5381;
-        for (char c : key) hash = ((hash << 5) + hash) + c; 
-        return hash % capacity;
-    }
-
-public:
-    UserHashTable(int cap = 101) : capacity(cap) 
-    { 
-        table = new UserEntry[capacity]; 
+        table = new ProbeEntry[capacity];
+        occupied = new bool[capacity]();
     }
     
-    ~UserHashTable() 
+    ~QuadraticProbeTable() 
     {
-        // Delete all User objects before deleting table
-        for(int i=0; i<capacity; i++) 
-        {
-            if(table[i].occupied && table[i].value) 
-            {
-                delete table[i].value;
-            }
-        }
         delete[] table; 
+        delete[] occupied;
     }
     
-    void insert(string username, User* user) 
+    int hashFunction(const string& key) 
     {
-        int index = hashFunction(username); int i = 0;
-        while (i < capacity) 
+        unsigned long hash = 5381;
+        for (char c : key) hash = ((hash << 5) + hash) + c;
+        return hash % capacity;
+    }
+    
+    void insert(const string& key, Parcel* value) 
+    {
+        int index = hashFunction(key);
+        for (int i = 0; i < capacity; i++) 
         {
-            int probe = (index + i * i) % capacity;
-            if (!table[probe].occupied || table[probe].key == username) 
+            int probe = (int)((index + (long long)i * i) % capacity);
+            if (!occupied[probe] || table[probe].key == key) 
             {
-                table[probe].key = username; table[probe].value = user; table[probe].occupied = true; return;
+                table[probe].key = key; table[probe].value = value; occupied[probe] = true; return;
             }
-            i++;
         }
     }
     
-    User* search(string username) 
+    Parcel* search(const string& key) 
     {
-        int index = hashFunction(username); int i = 0;
-        while (i < capacity) 
+        int index = hashFunction(key);
+        for (int i = 0; i < capacity; i++) 
         {
-            int probe = (index + i * i) % capacity;
-            if (!table[probe].occupied) return nullptr;
-            if (table[probe].key == username) return table[probe].value;
-            i++;
+            int probe = (int)((index + (long long)i * i) % capacity);
+            if (!occupied[probe]) return nullptr;
+            if (table[probe].key == key) return table[probe].value;
         }
         return nullptr;
     }
-    
-    void saveToFile(ofstream& out) 
-    {
-         for(int i=0; i<capacity; i++) 
-         {
-             if(table[i].occupied) 
-             {
-                 User* u = table[i].value;
-                 out << u->username << "," << u->password << "," << u->role << endl;
-             }
-         }
-    }
-};
-
-
-struct UndoAction 
-{ 
-    string type; 
-    string parcelId; 
-};
-
-struct UndoNode 
-{ 
-    UndoAction data; 
-    UndoNode* next; 
-    UndoNode(UndoAction d) : data(d), next(nullptr) {} 
 };
 
-class ActionStack 
+// database.search throughput at rising load factors: Swiss table vs the old quadratic probing.
+// Both tables get the same slot count and are filled without resizing; each key is looked up
+// once as a hit, and as many absent keys as a miss, in shuffled order as real scans arrive.
+void benchmarkParcelSearch(int capacity) 
 {
-private:
-    UndoNode* topNode;
-
-public:
-
-    ActionStack() : topNode(nullptr) {}
-    
-    void push(string type, string id) 
-    { 
-        UndoNode* n = new UndoNode({type, id}); 
-        n->next = topNode; 
-        topNode = n; 
+    cout << "\n[ PARCEL SEARCH BENCHMARK ] " << capacity << " slots, ";
+#if defined(__AVX2__)
+    cout << "AVX2 groups of " << HASH_GROUP << "\n";
+#elif defined(HAS_SSE2)
+    cout << "SSE2 groups of " << HASH_GROUP << "\n";
+#else
+    cout << "scalar groups of " << HASH_GROUP << "\n";
+#endif
+    const double loads[3] = { 0.5, 0.75, 0.875 };
+    int maxKeys = (int)(capacity * loads[2]);
+    string* keys = new string[maxKeys];
+    string* misses = new string[maxKeys];
+    int* order = new int[maxKeys];
+    for (int i = 0; i < maxKeys; i++) 
+    {
+        keys[i] = "PK" + to_string(i);
+        misses[i] = "MS" + to_string(i);
+        order[i] = i;
     }
+    int prime = capacity + 1;
+    for (bool isPrime = false; !isPrime; prime += 2) 
+    {
+        isPrime = true;
+        for (int d = 3; d * d <= prime && isPrime; d += 2) 
+        if (prime % d == 0) isPrime = false;
+    }
+    prime -= 2;
+    Parcel dummy;
     
-    bool pop(UndoAction& dest) 
+    cout << fixed << setprecision(1);
+    cout << "  Load    Quadratic ns/op    Swiss ns/op    Speedup\n";
+    for (int l = 0; l < 3; l++) 
     {
-        if(!topNode) 
-        return false;
+        int n = (int)(capacity * loads[l]);
+        for (int i = n - 1; i > 0; i--) 
+        swap(order[i], order[((long long)rand() * (RAND_MAX + 1LL) + rand()) % (i + 1)]);
+        QuadraticProbeTable baseline(prime);
+        ParcelHashTable swiss(capacity, 0.9, false);
+        for (int i = 0; i < n; i++) 
+        {
+            baseline.insert(keys[i], &dummy);
+            swiss.insert(keys[i], &dummy);
+        }
         
-        UndoNode* temp = topNode; 
-        dest = temp->data; 
-        topNode = topNode->next; 
-        delete temp; 
+        int errors = 0;
+        clock_t t0 = clock();
+        for (int i = 0; i < n; i++) 
+        if (baseline.search(keys[order[i]]) != &dummy) errors++;
+        for (int i = 0; i < n; i++) 
+        if (baseline.search(misses[order[i]])) errors++;
+        double baseMs = elapsedMs(t0);
         
-        return true;
+        t0 = clock();
+        for (int i = 0; i < n; i++) 
+        if (swiss.search(keys[order[i]]) != &dummy) errors++;
+        for (int i = 0; i < n; i++) 
+        if (swiss.search(misses[order[i]])) errors++;
+        double swissMs = elapsedMs(t0);
+        
+        double baseNs = baseMs * 1e6 / (2.0 * n);
+        double swissNs = swissMs * 1e6 / (2.0 * n);
+        cout << "  " << setw(5) << loads[l] * 100 << "%  " << setw(12) << baseNs << "       " << setw(10) << swissNs 
+             << "     " << setprecision(2) << (swissNs > 0 ? baseNs / swissNs : 0) << "x" << setprecision(1) 
+             << (errors ? "   MISMATCH" : "") << "\n";
+        if (swiss.getCapacity() != capacity) cout << "  (Swiss table resized during fill)\n";
     }
-};
+    cout.unsetf(ios::fixed); 
+    cout << setprecision(6);
+    delete[] keys;
+    delete[] misses;
+    delete[] order;
+}
+
+
+// Lifecycle ticks over n parcels in transit whose arrivals are spread over 'spread' seconds.
+// A tick only touches parcels whose event is due, so its cost follows the due count, not n.
+void benchmarkLifecycle(int n, int spread) 
+{
+    cout << "\n[ LIFECYCLE TICK BENCHMARK ] " << n << " parcels in transit, arrivals over " << spread << " s\n";
+    Parcel* parcels = new Parcel[n];
+    ParcelLinkedList shipped;
+    long long start = time(0);
+    for (int i = 0; i < n; i++) 
+    {
+        parcels[i].status = STATUS_IN_TRANSIT;
+        parcels[i].arrivalTime = start + 1 + ((long long)rand() * (RAND_MAX + 1LL) + rand()) % spread;
+        shipped.pushBack(&parcels[i]);
+    }
+    
+    // Nothing is due before start + 1
+    const int quietTicks = 1000;
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    for (int t = 0; t < quietTicks; t++) 
+    shipped.updateLifecycle(start);
+    std::chrono::duration<double, std::micro> quiet = std::chrono::steady_clock::now() - t0;
+    
+    const int busyTicks = 60;
+    long long events = 0;
+    t0 = std::chrono::steady_clock::now();
+    for (int t = 1; t <= busyTicks; t++) 
+    events += shipped.updateLifecycle(start + t);
+    std::chrono::duration<double, std::micro> busy = std::chrono::steady_clock::now() - t0;
+    
+    cout << fixed << setprecision(2);
+    cout << "  Idle tick (nothing due):  " << quiet.count() / quietTicks << " us\n";
+    cout << "  " << busyTicks << " busy ticks:           " << events << " events, " << busy.count() / busyTicks 
+         << " us/tick, " << (events > 0 ? busy.count() * 1000 / events : 0) << " ns/event\n";
+    cout << "  Still scheduled:          " << shipped.pendingEvents() << "\n";
+    cout.unsetf(ios::fixed); 
+    cout << setprecision(6);
+    delete[] parcels;
+}
 
 class LogisticsEngine 
 {
 private:
     ParcelHashTable database;
-    ParcelHeap sortingQueue;   
+    HubQueueSet hubQueues;     // One sorting queue per warehouse hub (sharded by zone)
+    NameIndex zoneShards;      // Zone name -> shard of the hub queues and rider pool
+    int zoneShardCount;
+    SlaStats sla;              // Dispatch deadline hits and misses
     ParcelLinkedList shippingList; 
-    RiderQueue riderQueue;     
+    RiderPool riders;          
     MapGraph map;
+    RoadParcelIndex routeUsage; // Road -> in-flight parcels routed over it
     ActionStack undoStack;
     UserHashTable users;
     User* currentUser;
 
     
 public:
-    LogisticsEngine() : currentUser(nullptr)
+    LogisticsEngine(int queueKind = QUEUE_KIND_HEAP) : hubQueues(queueKind), zoneShardCount(0), currentUser(nullptr)
     {
         srand(time(0));
         setupUsers();
@@ -1433,6 +5980,7 @@ public:
         
         
         
+        const RoadNetworkCSR& g = map.getCSR();
         for(int pass=0; pass<3; pass++)
         {
             for(int i=0; i<map.cityCount; i++)
@@ -1440,14 +5988,13 @@ public:
                 if(!coords[i].resolved)
                 {
                     // Check neighbors
-                    EdgeArrayList& edges = map.cities[i].edges;
-                    for(int j=0; j<edges.size(); j++)
+                    for(int a=g.arcBegin(i); a<g.arcEnd(i); a++)
                     {
-                        int neighborIdx = edges.getRef(j).dest;
+                        int neighborIdx = g.dest[a];
                         if(coords[neighborIdx].resolved)
                         {
                             
-                            int distKm = edges.getRef(j).weight;
+                            int distKm = g.weight[a];
                             
                             
                             double angle = (i * 1.0) + (neighborIdx * 0.5); 
@@ -1503,15 +6050,14 @@ public:
         bool first = true;
         for(int i=0; i<map.cityCount; i++)
         {
-            EdgeArrayList& edges = map.cities[i].edges;
-            for(int j=0; j<edges.size(); j++)
+            for(int a=g.arcBegin(i); a<g.arcEnd(i); a++)
             {
-                Edge& e = edges.getRef(j);
-                if(i < e.dest) // Undirected, only print once
+                int v = g.dest[a];
+                if(i < v) // Undirected, only print once
                 {
                     if(!first) out << ",\n";
-                    out << "    { \"u\": \"" << map.cities[i].name << "\", \"v\": \"" << map.cities[e.dest].name 
-                        << "\", \"weight\": " << e.weight << ", \"blocked\": " << (e.isBlocked ? "true" : "false") << " }";
+                    out << "    { \"u\": \"" << map.cities[i].name << "\", \"v\": \"" << map.cities[v].name 
+                        << "\", \"weight\": " << g.weight[a] << ", \"blocked\": " << (g.isBlocked(a) ? "true" : "false") << " }";
                     first = false;
                 }
             }
@@ -1520,7 +6066,7 @@ public:
 
         // 3. Export Riders
         out << "  \"riders\": [\n";
-        riderQueue.exportJSON(out);
+        riders.exportJSON(out);
         out << "\n  ],\n";
 
         // 4. Export Parcels
@@ -1543,7 +6089,7 @@ public:
         if(map.addCity(name, zone) != -1) 
              cout << ">> City Added.\n";
         else 
-             cout << ">> Map Full!\n";
+             cout << ">> City Already Exists!\n";
         pauseFunc();
     }
     
@@ -1561,8 +6107,8 @@ public:
         
         if(u>=0 && u<map.cityCount && v>=0 && v<map.cityCount) 
         {
-            map.addRoad(u, v, w);
-            cout << ">> Road Added.\n";
+            if(map.addRoad(u, v, w)) cout << ">> Road Added.\n";
+            else cout << ">> Road Already Exists (or same city).\n";
         }
         else cout << ">> Invalid Cities.\n";
         pauseFunc();
@@ -1584,8 +6130,12 @@ public:
         
         if(u>=0 && u<map.cityCount && v>=0 && v<map.cityCount) 
         {
-            map.setRoadStatus(u, v, (status==1));
-            cout << ">> Road Status Updated.\n";
+            if(map.setRoadStatus(u, v, (status==1))) 
+            {
+                cout << ">> Road Status Updated.\n";
+                if(status == 1) rerouteAffectedParcels(u, v);
+            }
+            else cout << ">> No Road Between These Cities.\n";
         }
         else cout << ">> Invalid IDs.\n";
         pauseFunc();
@@ -1612,10 +6162,10 @@ public:
             // 2. Operational Cleanup: Free the Rider
             if (p->assignedRider != "") 
             {
-               releaseRider(p->assignedRider);
+               string rider = p->assignedRider;
+               releaseRider(p); // Also unassigns
                setColor(COLOR_YELLOW);
-               cout << "   >> Alert: Rider capacity freed for " << p->assignedRider << ".\n";
-               p->assignedRider = ""; // Unassign
+               cout << "   >> Alert: Rider capacity freed for " << rider << ".\n";
                resetColor();
             }
             
@@ -1661,32 +6211,282 @@ public:
     void setupRiders() 
     {
         
-        riderQueue.enqueue(Rider("Ali Khan", 1, 1));      // Standard
-        riderQueue.enqueue(Rider("Bilal Ahmed", 1, 1));   // Standard
-        riderQueue.enqueue(Rider("Asad Malik", 1, 2));    // Express
-        riderQueue.enqueue(Rider("Usman Tariq", 1, 2));   // Express
-        riderQueue.enqueue(Rider("Fahad Mustafa", 1, 1)); // Standard
-        riderQueue.enqueue(Rider("Ahmed Raza", 1, 1));    // Standard
-        riderQueue.enqueue(Rider("Imran Haider", 1, 2));  // Express
-        riderQueue.enqueue(Rider("Zain Sheikh", 1, 2));   // Express
-        riderQueue.enqueue(Rider("Hamza Ali", 1, 1));     // Standard
-        riderQueue.enqueue(Rider("Hassan Bib", 1, 1));    // Standard
+        addRider(Rider("Ali Khan", 8, 1, 60, "Zone A"));      // Standard van
+        addRider(Rider("Bilal Ahmed", 8, 1, 60, "Zone B"));   // Standard van
+        addRider(Rider("Asad Malik", 4, 2, 25, "Zone A"));    // Express bike
+        addRider(Rider("Usman Tariq", 4, 2, 25, "Zone B"));   // Express bike
+        addRider(Rider("Fahad Mustafa", 8, 1, 60, "Zone C")); // Standard van
+        addRider(Rider("Ahmed Raza", 8, 1, 60, "Zone D"));    // Standard van
+        addRider(Rider("Imran Haider", 4, 2, 25, "Zone C"));  // Express bike
+        addRider(Rider("Zain Sheikh", 4, 2, 25, "Zone D"));   // Express bike
+        addRider(Rider("Hamza Ali", 8, 1, 60, "Zone A"));     // Standard van
+        addRider(Rider("Hassan Bib", 8, 1, 60, "Zone B"));    // Standard van
+    }
+    
+    // A rider joins the pool shard of their home zone
+    int addRider(Rider r) 
+    {
+        r.shard = zoneShard(r.zone);
+        return riders.addRider(r);
+    }
+    
+    // Shard of a zone name, registered on first use
+    int zoneShard(const string& zone) 
+    {
+        int s = zoneShards.find(zone);
+        if (s == -1) 
+        {
+            s = zoneShardCount++;
+            zoneShards.insert(zone, s);
+        }
+        return s;
     }
     
     // Display Functions
     void displayRiders()
     {
         clearScreen();
-        riderQueue.displayAll();
+        riders.displayAll();
+        
+        // What each rider is carrying right now, read from the database's rider index (a parcel
+        // leaves it as soon as its rider is released)
+        cout << "\n   [ PARCELS ON BOARD ]\n";
+        bool any = false;
+        for (int r = 0; r < riders.size(); r++) 
+        {
+            ParcelArrayList assigned;
+            database.collectRider(r, assigned);
+            for (int i = 0; i < assigned.size(); i++) 
+            {
+                Parcel* p = assigned.get(i);
+                cout << "   " << left << setw(20) << riders.get(r)->name << setw(8) << p->id 
+                     << "-> " << setw(12) << p->destination << " [" << p->getStatusString() << "]\n";
+                any = true;
+            }
+        }
+        if (!any) cout << "   (No parcels on board)\n";
         pauseFunc();
     }
     
-    // Helper to free up rider capacity
-    void releaseRider(string name)
+    // Helper to free up the capacity (and weight) a parcel held on its rider. The parcel is
+    // unassigned too, so the rider index only ever lists what a rider is carrying.
+    void releaseRider(Parcel* p)
+    {
+        riders.release(p->assignedRiderId, p->weight);
+        p->assignRider("", -1);
+    }
+    
+    // Real seconds the simulation needs for 'minutes' of simulated driving (at least 1)
+    static long long simSecondsFor(int minutes) 
+    {
+        long long secs = (minutes + SIM_MINUTES_PER_SECOND - 1) / SIM_MINUTES_PER_SECOND;
+        return secs > 0 ? secs : 1;
+    }
+    
+    // Adds the time-dependent fastest route to the current options (replacing the option with
+    // the worst drive time when all are taken) and fills etaMinutes with each option's drive
+    // time at departMinute. Returns the index of the fastest option.
+    int addTrafficAwareRoute(int start, int end, long long departMinute, int* etaMinutes) 
+    {
+        int slowIdx = -1;
+        for (int i = 0; i < map.pathCount; i++) 
+        {
+            etaMinutes[i] = map.routeTravelMinutes(map.availablePaths[i], departMinute);
+            if (slowIdx == -1 || etaMinutes[i] > etaMinutes[slowIdx]) 
+            slowIdx = i;
+        }
+        
+        IntArrayList fastest;
+        int fastestMinutes = map.fastestPath(start, end, departMinute, fastest);
+        if (fastestMinutes != -1) 
+        {
+            int km = 0;
+            for (int i = 0; i + 1 < fastest.size(); i++) 
+            km += map.roadLength(fastest.get(i), fastest.get(i + 1));
+            int idx = map.addRouteOption(fastest, km, slowIdx);
+            if (idx != -1) 
+            etaMinutes[idx] = map.routeTravelMinutes(map.availablePaths[idx], departMinute);
+        }
+        
+        int fastIdx = -1;
+        for (int i = 0; i < map.pathCount; i++) 
+        if (fastIdx == -1 || etaMinutes[i] < etaMinutes[fastIdx]) 
+        fastIdx = i;
+        return fastIdx;
+    }
+    
+    // Store the dispatched route on the parcel and register it on every road it uses
+    void assignRoute(Parcel* p, const IntArrayList& path, int dist) 
+    {
+        if (!p->route) p->route = new IntArrayList();
+        *p->route = path;
+        p->routeDistance = dist;
+        indexRoute(p);
+    }
+    
+    void indexRoute(Parcel* p) 
+    {
+        for (int i = 0; i + 1 < p->route->size(); i++) 
+        routeUsage.add(p->route->get(i), p->route->get(i + 1), p);
+    }
+    
+    // Estimated position of an in-flight parcel: index of the last city passed on its route.
+    // Loading parcels are still at the hub; in transit, progress is linear in time.
+    int estimateRoutePosition(Parcel* p, long long now, int& travelledKm) 
+    {
+        travelledKm = 0;
+        if (p->status != STATUS_IN_TRANSIT) 
+        return 0;
+        
+        long long departed = p->dispatchTime + 5;
+        long long total = p->arrivalTime - departed;
+        double frac = (total > 0) ? (double)(now - departed) / total : 1.0;
+        if (frac < 0) frac = 0;
+        if (frac > 1) frac = 1;
+        
+        double target = frac * p->routeDistance;
+        int pos = 0;
+        for (int i = 0; i + 1 < p->route->size(); i++) 
+        {
+            int w = map.roadLength(p->route->get(i), p->route->get(i + 1));
+            if (travelledKm + w > target) 
+            break;
+            travelledKm += w;
+            pos = i + 1;
+        }
+        return pos;
+    }
+    
+    // Road (u,v) was just closed: repair the routes of in-flight parcels that still have it ahead.
+    // Only the affected parcels are visited; each keeps its travelled prefix and gets a fresh
+    // fastest suffix (current traffic) from its current city. Returns the number of parcels rerouted.
+    int rerouteAffectedParcels(int u, int v) 
+    {
+        ParcelArrayList* bucket = routeUsage.get(u, v);
+        if (!bucket || bucket->isEmpty()) 
+        return 0;
+        
+        // Detach the bucket contents; parcels that keep using the road are re-registered below
+        ParcelArrayList affected;
+        for (int i = 0; i < bucket->size(); i++) 
+        affected.add(bucket->get(i));
+        while (!bucket->isEmpty()) 
+        bucket->removeLast();
+        
+        long long now = time(0);
+        int rerouted = 0;
+        IntArrayList suffix, repaired;
+        
+        for (int i = 0; i < affected.size(); i++) 
+        {
+            Parcel* p = affected.get(i);
+            if (!RoadParcelIndex::isInFlight(p) || !p->route) 
+            continue;
+            
+            // Where on the route is the closed road?
+            int closedAt = -1;
+            for (int k = 0; k + 1 < p->route->size() && closedAt == -1; k++) 
+            {
+                int a = p->route->get(k), b = p->route->get(k + 1);
+                if ((a == u && b == v) || (a == v && b == u)) 
+                closedAt = k;
+            }
+            if (closedAt == -1) 
+            continue; // Stale entry: route changed since registration
+            
+            int travelled;
+            int pos = estimateRoutePosition(p, now, travelled);
+            if (closedAt < pos) 
+            {
+                routeUsage.add(u, v, p); // Already past the closure
+                continue;
+            }
+            
+            // Fastest suffix under current traffic, leaving 'here' now (or when loading ends)
+            int here = p->route->get(pos);
+            long long leaveAt = (p->dispatchTime + 5 > now) ? p->dispatchTime + 5 : now;
+            int suffixMinutes = map.fastestPath(here, p->route->get(p->route->size() - 1), simMinuteNow(leaveAt), suffix);
+            if (suffixMinutes == -1) 
+            {
+                p->updateStatus(STATUS_RETURNED, "Road Closure - No Alternative Route, RTS", map.cities[here].name);
+                if (p->assignedRider != "") releaseRider(p);
+                continue;
+            }
+            
+            repaired.clear();
+            for (int k = 0; k < pos; k++) 
+            repaired.add(p->route->get(k));
+            for (int k = 0; k < suffix.size(); k++) 
+            repaired.add(suffix.get(k));
+            
+            int suffixDist = 0;
+            for (int k = 0; k + 1 < suffix.size(); k++) 
+            suffixDist += map.roadLength(suffix.get(k), suffix.get(k + 1));
+            p->arrivalTime = leaveAt + simSecondsFor(suffixMinutes);
+            shippingList.reschedule(p);
+            
+            assignRoute(p, repaired, travelled + suffixDist);
+            p->history->addEvent("Rerouted around closed road " + map.cities[u].name + " - " + map.cities[v].name, 
+                                 map.cities[here].name);
+            rerouted++;
+        }
+        
+        if (rerouted > 0) 
+        cout << ">>> " << rerouted << " in-flight parcel(s) rerouted around the closure.\n";
+        return rerouted;
+    }
+
+    // Default warehouses (those present in the map); a map without any gets its first city
+    void setupHubs() 
+    {
+        string defaults[3] = { "Lahore", "Karachi", "Islamabad" };
+        for (int i = 0; i < 3; i++) 
+        map.addHub(map.getCityIndex(defaults[i]));
+        if (map.getHubCount() == 0 && map.cityCount > 0) 
+        map.addHub(0);
+    }
+    
+    string hubName(int slot) 
+    {
+        return map.cities[map.getHubCity(slot)].name;
+    }
+    
+    // Queue a warehouse parcel at its origin hub, assigning the nearest open hub if it has
+    // none (or its hub was closed). Returns false if no open hub can reach the destination.
+    bool enqueueAtHub(Parcel* p) 
+    {
+        int hub = p->originHub;
+        if (hub < 0 || hub >= map.getHubCount() || !map.isHubOpen(hub)) 
+        hub = map.nearestHub(map.getCityIndex(p->destination));
+        if (hub == -1) 
+        return false;
+        p->originHub = hub;
+        p->shard = zoneShard(p->zone);
+        hubQueues.at(hub).insert(p);
+        return true;
+    }
+    
+    // Take a parcel out of its hub's sorting queue (no-op if it is not queued)
+    bool dequeueFromHub(Parcel* p) 
+    {
+        if (p->originHub < 0 || p->originHub >= hubQueues.size()) 
+        return false;
+        return hubQueues.at(p->originHub).remove(p);
+    }
+    
+    // Open hub whose most urgent waiting parcel outranks every other hub's, -1 if none waits
+    int pickDispatchHub() 
     {
-        riderQueue.decrementLoad(name);
+        int best = -1;
+        for (int h = 0; h < hubQueues.size() && h < map.getHubCount(); h++) 
+        {
+            Parcel* top = hubQueues.at(h).peekMax();
+            if (top && map.isHubOpen(h) && (best == -1 || hubQueues.outranks(top, hubQueues.at(best).peekMax()))) 
+            best = h;
+        }
+        return best;
     }
-
+    
     void setupDefaultMap() 
     {
         int lhr = map.addCity("Lahore", "Zone A"); 
@@ -1712,6 +6512,7 @@ public:
         map.addRoad(suk, khi, 470); 
         map.addRoad(suk, qta, 390); 
         map.addRoad(qta, khi, 690);
+        setupHubs();
 
     }
     
@@ -1770,19 +6571,26 @@ public:
         }
         
         // Calculate Cost
-        int start = map.getCityIndex("Lahore"); // Assume picked up from HQ for now
         int end = map.getCityIndex(dest);
+        int hub = map.nearestHub(end);
+        if (hub == -1) 
+        {
+            setColor(COLOR_RED); cout << "Error: No open hub can reach " << dest << ".\n"; resetColor();
+            pauseFunc(); 
+            return; 
+        }
+        int start = map.getHubCity(hub);
         double dist = 0;
         
-        map.findAllPaths(start, end);
-        if(map.pathCount > 0) dist = map.availablePathDistances[map.getMinRouteIndex()];
+        int best = map.routeDistance(start, end);
+        if(best != -1) dist = best;
         
         double cost = calculateShippingCost(w, dist, p);
         
         cout << "\n--------------------------------\n";
         cout << "      SHIPPING QUOTE\n";
         cout << "--------------------------------\n";
-        cout << " Source:      Lahore (Central Warehouse)\n";
+        cout << " Source:      " << hubName(hub) << " (Nearest Hub)\n";
         cout << " Destination: " << dest << "\n";
         cout << " Distance:    " << dist << " km\n";
         cout << " Weight:      " << w << " kg\n";
@@ -1800,11 +6608,12 @@ public:
         // Link parcel to user history (simulated by simple log for now, or could add list to User)
         newP->history->addEvent("Created by User: " + (currentUser ? currentUser->username : "Unknown"), "Portal");
 
-        newP->updateStatus(STATUS_WAREHOUSE, "Arrived at Warehouse", "Central Hub");
+        newP->updateStatus(STATUS_WAREHOUSE, "Arrived at Warehouse", hubName(hub) + " Hub");
         
-        sortingQueue.insert(newP); 
+        newP->originHub = hub;
+        enqueueAtHub(newP); 
         
-        undoStack.push("ADD", id);
+        undoStack.push("ADD", newP->handle);
         cout << ">> Pickup Request Logged.\n";
         pauseFunc();
     }
@@ -1815,14 +6624,16 @@ public:
         if(!isAdmin()) { cout << "Access Denied.\n"; pauseFunc(); return; }
         
         clearScreen();
-        if(sortingQueue.isEmpty()) 
+        int hub = pickDispatchHub();
+        if(hub == -1) 
         { 
             cout << ">> Warehouse Queue Empty.\n"; 
             pauseFunc(); 
             return; 
         }
         
-        Parcel* p = sortingQueue.extractMax();
+        HubQueue& queue = hubQueues.at(hub);
+        Parcel* p = queue.extractMax();
         if(!p) 
         {
              cout << "Warehouse Queue is Empty.\n";
@@ -1833,26 +6644,30 @@ public:
         // Use Intelligent Rider Selection Algorithm
         cout << ">> Analyzing best rider for parcel " << p->id << "...\n";
         
-        Rider* r = riderQueue.findAvailableRider(p->priority);
+        Rider* r = riders.findAvailableRider(p->priority, p->weight);
         
         if(!r) 
         {
             cout << "No Suitable Riders Available! (All busy or at capacity)\n";
-            sortingQueue.insert(p); // Put back
+            queue.insert(p); // Put back
             pauseFunc();
             return;
         }
         
         // Display selection
         cout << "✓ Selected Rider: " << r->name << " (" << ((r->priorityLevel==2)?"Express":"Standard") << ")\n";
-        cout << "  Current Load: " << r->currentLoad << "/" << r->capacity << " parcels\n\n";
+        cout << "  Current Load: " << r->currentLoad << "/" << r->capacity << " parcels, " 
+             << r->loadWeight << "/" << r->maxWeight << " kg\n\n";
         
         // Find and display all available routes
-        int start = map.getCityIndex("Lahore");
+        int start = map.getHubCity(hub);
         int end = map.getCityIndex(p->destination);
         
-        cout << ">> Calculating routes for " << p->id << " to " << p->destination << "...\n";
+        cout << ">> Calculating routes for " << p->id << " from " << hubName(hub) << " hub to " << p->destination << "...\n";
+        long long departMinute = simMinuteNow(time(0) + 5); // Leaves the hub after loading
+        int etaMinutes[MAX_ROUTE_OPTIONS];
         map.findAllPaths(start, end);
+        int fastIdx = addTrafficAwareRoute(start, end, departMinute, etaMinutes);
         
         if (map.pathCount == 0) 
         {
@@ -1871,9 +6686,11 @@ public:
         for(int i=0; i<map.pathCount; i++) 
         {
             cout << "\n[Route " << i << "] ";
-            if(i == minIdx) cout << "⭐ RECOMMENDED - SHORTEST";
+            if(i == fastIdx) cout << "⭐ RECOMMENDED - FASTEST NOW";
+            else if(i == minIdx) cout << "(Shortest)";
             cout << "\n";
             cout << "  Distance: " << map.availablePathDistances[i] << " km\n";
+            cout << "  Drive Time: " << etaMinutes[i] / 60 << "h " << etaMinutes[i] % 60 << "m (current traffic)\n";
             cout << "  Path: ";
             
             IntArrayList& path = map.availablePaths[i];
@@ -1889,26 +6706,28 @@ public:
         
         // User selects route
         int choice;
-        cout << "\n>> Select Route ID to Dispatch [0-" << (map.pathCount-1) << "] (Recommended: " << minIdx << "): ";
+        cout << "\n>> Select Route ID to Dispatch [0-" << (map.pathCount-1) << "] (Recommended: " << fastIdx << "): ";
         cin >> choice;
         
         if (choice < 0 || choice >= map.pathCount) 
         {
             cout << "Invalid selection. Using Recommended Route.\n";
-            choice = minIdx;
+            choice = fastIdx;
         }
         
         // Check for random road blockage
         if (rand() % 10 < 2) 
         { 
             cout << "\n>>> [LIVE UPDATE] Road Blockage Detected on selected route!\n";
-            map.blockRandomRoad();
+            int bu, bv;
+            if (map.blockRandomRoad(bu, bv)) 
+            rerouteAffectedParcels(bu, bv);
             cout << ">>> Re-calculating Best Route automatically...\n";
             map.findAllPaths(start, end); 
             
             if (map.pathCount > 0) 
             {
-                choice = map.getMinRouteIndex(); 
+                choice = addTrafficAwareRoute(start, end, departMinute, etaMinutes); 
                 cout << ">>> Rerouted to new optimal path.\n";
             } 
             else 
@@ -1920,26 +6739,16 @@ public:
             }
         }
         
-        // Assign to rider
-        r->currentLoad++;
-        
-        p->assignedRider = r->name;
-        // Simplified status update
-        p->updateStatus(STATUS_LOADING, "Loaded onto " + r->name + "'s Vehicle", "Warehouse");
-        shippingList.pushBack(p);
-        
-        long long travelSecs = 10 + (rand() % 21);
-        p->dispatchTime = time(0);
-        p->arrivalTime = time(0) + travelSecs + 5;
-        
-        undoStack.push("DISPATCH", p->id);
+        commitDispatch(p, r, hub, map.availablePaths[choice], map.availablePathDistances[choice], etaMinutes[choice]);
+        long long travelSecs = simSecondsFor(etaMinutes[choice]);
         
         cout << "\n";
         setColor(COLOR_GREEN); cout << ">> PARCEL DISPATCHED SUCCESSFULLY.\n"; resetColor();
         cout << "   Parcel: " << p->id << " (Priority " << p->priority << ", " << p->weight << " kg)\n";
         cout << "   Rider: " << r->name << "\n";
         cout << "   Route: " << choice << " (Distance: " << map.availablePathDistances[choice] << " km)\n";
-        cout << "   ETA: " << travelSecs << "s (transit) + 5s (loading)\n";
+        cout << "   ETA: " << travelSecs << "s (transit, " << etaMinutes[choice] / 60 << "h " << etaMinutes[choice] % 60 
+             << "m simulated) + 5s (loading)\n";
         cout << "   Rider Load: ";
         if(r->currentLoad >= r->capacity) setColor(COLOR_RED); else setColor(COLOR_GREEN);
         cout << r->currentLoad << "/" << r->capacity; resetColor(); cout << " parcels\n";
@@ -1947,6 +6756,483 @@ public:
         pauseFunc();
     }
 
+    // Hand a parcel to a rider on the given route: shared by the interactive and batch paths.
+    // Returns true if the parcel left after its SLA deadline.
+    bool commitDispatch(Parcel* p, Rider* r, int hub, const IntArrayList& path, int km, int etaMinutes) 
+    {
+        riders.assign(r, p->weight);
+        assignRoute(p, path, km);
+        return recordDispatch(p, r, hub, etaMinutes);
+    }
+    
+    // Bookkeeping once a parcel holds its rider and route: SLA check, status, shipping list, undo.
+    // Returns true if the dispatch missed its SLA deadline.
+    bool recordDispatch(Parcel* p, Rider* r, int hub, int etaMinutes) 
+    {
+        bool missed = sla.record(p, time(0));
+        if (missed) 
+        p->history->addEvent("Dispatch SLA missed", hubName(hub) + " Hub");
+        
+        p->assignRider(r->name, r->id);
+        p->updateStatus(STATUS_LOADING, "Loaded onto " + r->name + "'s Vehicle", hubName(hub) + " Hub");
+        shippingList.pushBack(p);
+        
+        long long travelSecs = simSecondsFor(etaMinutes);
+        p->dispatchTime = time(0);
+        p->arrivalTime = time(0) + travelSecs + 5;
+        
+        undoStack.push("DISPATCH", p->handle);
+        return missed;
+    }
+    
+    // Drain the hub queues without prompts: most urgent parcel first, recommended (fastest)
+    // route, first suitable rider. Stops after 'limit' parcels (0 = no limit), once
+    // 'budgetMs' of CPU time is spent (0 = no budget), or when the fleet is saturated.
+    BatchDispatchSummary dispatchBatch(int limit, double budgetMs) 
+    {
+        BatchDispatchSummary sum;
+        clock_t t0 = clock();
+        IntArrayList route;
+        
+        while (limit <= 0 || sum.dispatched + sum.returned < limit) 
+        {
+            if (budgetMs > 0 && elapsedMs(t0) >= budgetMs) 
+            { 
+                sum.outOfTime = true; 
+                break; 
+            }
+            
+            int hub = pickDispatchHub();
+            if (hub == -1) 
+            break;
+            HubQueue& queue = hubQueues.at(hub);
+            Parcel* p = queue.extractMax();
+            
+            Rider* r = riders.findAvailableRider(p->priority, p->weight);
+            if (!r) 
+            {
+                queue.insert(p);
+                sum.fleetFull = true;
+                break;
+            }
+            
+            // Every parcel leaving this hub in the same simulated minute shares one search
+            long long departMinute = simMinuteNow(time(0) + 5);
+            int minutes = map.fastestFromHub(map.getHubCity(hub), map.getCityIndex(p->destination), departMinute, route);
+            if (minutes == -1) 
+            {
+                p->updateStatus(STATUS_RETURNED, "No Route Available", hubName(hub) + " Hub");
+                sum.returned++;
+                continue;
+            }
+            
+            int km = 0;
+            for (int i = 0; i + 1 < route.size(); i++) 
+            km += map.roadLength(route.get(i), route.get(i + 1));
+            if (commitDispatch(p, r, hub, route, km, minutes)) 
+            sum.late++;
+            sum.dispatched++;
+        }
+        
+        sum.elapsedMs = elapsedMs(t0);
+        for (int h = 0; h < hubQueues.size(); h++) 
+        sum.remaining += hubQueues.at(h).size();
+        return sum;
+    }
+    
+    // Most urgent parcel of one zone shard across the open hubs (taken under the shard's lock)
+    Parcel* takeFromShard(ShardWorker& w) 
+    {
+        std::lock_guard<std::mutex> guard(w.lock);
+        int best = -1;
+        for (int h = 0; h < hubQueues.size() && h < map.getHubCount(); h++) 
+        {
+            SortingQueue* q = hubQueues.at(h).findShard(w.shard);
+            Parcel* top = q ? q->peekMax() : nullptr;
+            if (top && map.isHubOpen(h) && (best == -1 || hubQueues.outranks(top, hubQueues.at(best).findShard(w.shard)->peekMax()))) 
+            best = h;
+        }
+        return best == -1 ? nullptr : hubQueues.at(best).findShard(w.shard)->extractMax();
+    }
+    
+    // Worker of one zone shard: drain the zone's queues with the zone's riders. Once the zone
+    // is empty its riders, if any still have room, steal the most urgent parcels of other zones.
+    // Only parcel-local state is written here; the shared bookkeeping waits for the join.
+    void drainShard(ShardWorker* w, ShardWorker* all, int count, long long departMinute, 
+                    std::chrono::steady_clock::time_point t0, double budgetMs) 
+    {
+        IntArrayList route;
+        while (true) 
+        {
+            std::chrono::duration<double, std::milli> spent = std::chrono::steady_clock::now() - t0;
+            if (budgetMs > 0 && spent.count() >= budgetMs) 
+            { 
+                w->outOfTime = true; 
+                break; 
+            }
+            
+            Parcel* p = takeFromShard(*w);
+            bool stolen = false;
+            for (int k = 1; !p && k < count; k++) 
+            {
+                if (!riders.findAvailableRider(1, 0, w->shard)) 
+                break; // Nobody here to carry a stolen parcel
+                p = takeFromShard(all[(w->shard + k) % count]);
+                stolen = (p != nullptr);
+            }
+            if (!p) 
+            break;
+            
+            Rider* r = riders.findAvailableRider(p->priority, p->weight, w->shard);
+            if (!r) 
+            {
+                std::lock_guard<std::mutex> guard(all[p->shard].lock);
+                hubQueues.at(p->originHub).insert(p);
+                w->fleetFull = true;
+                break;
+            }
+            
+            int minutes = map.fastestFromHub(map.getHubCity(p->originHub), map.getCityIndex(p->destination), departMinute, route);
+            if (minutes == -1) 
+            {
+                w->noRoute.add(p);
+                continue;
+            }
+            
+            int km = 0;
+            for (int i = 0; i + 1 < route.size(); i++) 
+            km += map.roadLength(route.get(i), route.get(i + 1));
+            riders.assign(r, p->weight);
+            if (!p->route) p->route = new IntArrayList();
+            *p->route = route;
+            p->routeDistance = km;
+            p->assignedRiderId = r->id;
+            w->loaded.add(p);
+            w->loadedEta.add(minutes);
+            if (stolen) w->stolen++;
+        }
+    }
+    
+    // Batch dispatch with one worker thread per zone shard. Everything the workers share is
+    // read-only while they run: the routing trees of the open hubs are built up front and every
+    // queue they can touch exists already. Loaded parcels are then published in one pass.
+    BatchDispatchSummary dispatchSharded(double budgetMs) 
+    {
+        BatchDispatchSummary sum;
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        long long departMinute = simMinuteNow(time(0) + 5);
+        
+        int count = zoneShardCount > 0 ? zoneShardCount : 1;
+        for (int h = 0; h < map.getHubCount(); h++) 
+        {
+            hubQueues.at(h).shard(count - 1);
+            if (map.isHubOpen(h)) 
+            map.getFastestTree(map.getHubCity(h), departMinute);
+        }
+        
+        ShardWorker* workers = new ShardWorker[count];
+        for (int s = 0; s < count; s++) 
+        workers[s].shard = s;
+        std::thread* pool = new std::thread[count];
+        for (int s = 0; s < count; s++) 
+        pool[s] = std::thread(&LogisticsEngine::drainShard, this, &workers[s], workers, count, departMinute, t0, budgetMs);
+        for (int s = 0; s < count; s++) 
+        pool[s].join();
+        delete[] pool;
+        
+        for (int s = 0; s < count; s++) 
+        {
+            ShardWorker& w = workers[s];
+            for (int i = 0; i < w.loaded.size(); i++) 
+            {
+                Parcel* p = w.loaded.get(i);
+                indexRoute(p);
+                if (recordDispatch(p, riders.get(p->assignedRiderId), p->originHub, w.loadedEta.get(i))) 
+                sum.late++;
+            }
+            for (int i = 0; i < w.noRoute.size(); i++) 
+            w.noRoute.get(i)->updateStatus(STATUS_RETURNED, "No Route Available", hubName(w.noRoute.get(i)->originHub) + " Hub");
+            
+            sum.dispatched += w.loaded.size();
+            sum.returned += w.noRoute.size();
+            sum.stolen += w.stolen;
+            if (w.fleetFull) sum.fleetFull = true;
+            if (w.outOfTime) sum.outOfTime = true;
+        }
+        delete[] workers;
+        
+        std::chrono::duration<double, std::milli> spent = std::chrono::steady_clock::now() - t0;
+        sum.elapsedMs = spent.count();
+        sum.workers = count;
+        for (int h = 0; h < hubQueues.size(); h++) 
+        sum.remaining += hubQueues.at(h).size();
+        return sum;
+    }
+    
+    // Idle rider (no parcels on board) for a trip whose most urgent parcel has 'priority'
+    Rider* findIdleRider(int priority) 
+    {
+        Rider* r = riders.findAvailableRider(priority, 0);
+        if (r && r->currentLoad > 0 && priority == 3) 
+        r = riders.findAvailableRider(1, 0); // Best of either level
+        return (r && r->currentLoad == 0) ? r : nullptr;
+    }
+    
+    // Work out the stop order of every trip: the distance tables one trip at a time (they
+    // share the map's search buffers), then the local search for all trips in parallel
+    void planTours(TripBin** bins, int count, ConsolidationSummary& sum) 
+    {
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+        TourJob** jobs = new TourJob*[count];
+        for (int b = 0; b < count; b++) 
+        {
+            TripBin& bin = *bins[b];
+            for (int i = 0; i < bin.parcels.size(); i++) 
+            {
+                int c = map.getCityIndex(bin.parcels.get(i)->destination);
+                bool seen = false;
+                for (int j = 0; j < bin.stops.size() && !seen; j++) 
+                seen = (bin.stops.get(j) == c);
+                if (!seen) bin.stops.add(c);
+            }
+            
+            int n = bin.stops.size() + 1;
+            int* cities = new int[n];
+            cities[0] = map.getHubCity(bin.hub);
+            for (int j = 1; j < n; j++) cities[j] = bin.stops.get(j - 1);
+            bin.dist = new int[n * n];
+            map.distanceTable(cities, n, bin.dist, TOUR_UNREACHABLE);
+            delete[] cities;
+            
+            bin.tour.n = n;
+            bin.tour.dist = bin.dist;
+            bin.tour.order = new int[n];
+            jobs[b] = &bin.tour;
+        }
+        
+        TourOptimizer::optimizeAll(jobs, count, TOUR_BUDGET_MS);
+        for (int b = 0; b < count; b++) 
+        {
+            sum.greedyKm += jobs[b]->greedyLength;
+            sum.tourKm += jobs[b]->length;
+        }
+        delete[] jobs;
+        std::chrono::duration<double, std::milli> spent = std::chrono::steady_clock::now() - t0;
+        sum.tourMs += spent.count();
+    }
+    
+    // Send one packed trip along its planned tour: each parcel's route is the trip prefix up
+    // to its stop and its ETA is the drive time along that prefix
+    void dispatchTrip(TripBin& bin, long long departMinute) 
+    {
+        int hub = bin.hub;
+        int stopCount = bin.stops.size();
+        IntArrayList trip, leg;
+        int* reachedAt = new int[stopCount];
+        int* visitNo = new int[stopCount];
+        for (int j = 0; j < stopCount; j++) reachedAt[j] = -1;
+        
+        int here = map.getHubCity(hub), visited = 0;
+        trip.add(here);
+        for (int t = 1; t < bin.tour.n; t++) 
+        {
+            int j = bin.tour.order[t] - 1;
+            if (map.shortestPath(here, bin.stops.get(j), leg) == -1) 
+            continue;
+            for (int k = 1; k < leg.size(); k++) trip.add(leg.get(k));
+            reachedAt[j] = trip.size() - 1;
+            visitNo[j] = ++visited;
+            here = bin.stops.get(j);
+        }
+        
+        IntArrayList prefix;
+        for (int i = 0; i < bin.parcels.size(); i++) 
+        {
+            Parcel* p = bin.parcels.get(i);
+            int c = map.getCityIndex(p->destination);
+            int j = 0;
+            while (bin.stops.get(j) != c) j++;
+            if (reachedAt[j] == -1) 
+            {
+                p->updateStatus(STATUS_RETURNED, "No Route Available", hubName(hub) + " Hub");
+                continue;
+            }
+            
+            prefix.clear();
+            int km = 0;
+            for (int k = 0; k <= reachedAt[j]; k++) 
+            {
+                prefix.add(trip.get(k));
+                if (k > 0) km += map.roadLength(trip.get(k - 1), trip.get(k));
+            }
+            commitDispatch(p, bin.rider, hub, prefix, km, map.routeTravelMinutes(prefix, departMinute));
+            p->history->addEvent("Consolidated trip: stop " + to_string(visitNo[j]) + " of " + to_string(stopCount) + 
+                                 " (" + to_string(bin.parcels.size()) + " parcels)", hubName(hub) + " Hub");
+        }
+        delete[] reachedAt; 
+        delete[] visitNo;
+    }
+    
+    // Consolidation stage: empty each open hub's queue, group the parcels by destination zone
+    // and pack every group onto idle riders with First-Fit Decreasing on weight (bins limited
+    // by the rider's weight and parcel capacity). A parcel heavier than a whole rider still
+    // travels alone. Parcels without an idle rider go back to their queue. Once all hubs are
+    // packed, every trip's stop order is optimized and the trips leave.
+    ConsolidationSummary consolidateAndDispatch() 
+    {
+        ConsolidationSummary sum;
+        long long departMinute = simMinuteNow(time(0) + 5);
+        int binCount = 0, binCapacity = 8;
+        TripBin** bins = new TripBin*[binCapacity];
+        
+        for (int hub = 0; hub < hubQueues.size() && hub < map.getHubCount(); hub++) 
+        {
+            if (!map.isHubOpen(hub)) 
+            continue;
+            HubQueue& queue = hubQueues.at(hub);
+            
+            // Group by zone, most urgent parcels first so they claim riders first
+            NameIndex zoneOf;
+            int groupCount = 0, groupCapacity = 8;
+            ParcelArrayList** groups = new ParcelArrayList*[groupCapacity];
+            ParcelArrayList held;
+            while (!queue.isEmpty()) 
+            {
+                Parcel* p = queue.extractMax();
+                int g = zoneOf.find(p->zone);
+                if (g == -1) 
+                {
+                    if (groupCount == groupCapacity) 
+                    {
+                        ParcelArrayList** grown = new ParcelArrayList*[groupCapacity * 2];
+                        for (int i = 0; i < groupCount; i++) grown[i] = groups[i];
+                        delete[] groups; 
+                        groups = grown; 
+                        groupCapacity *= 2;
+                    }
+                    g = groupCount++;
+                    groups[g] = new ParcelArrayList();
+                    zoneOf.insert(p->zone, g);
+                }
+                groups[g]->add(p);
+            }
+            
+            for (int g = 0; g < groupCount; g++) 
+            {
+                ParcelArrayList& group = *groups[g];
+                sortByWeightDesc(group);
+                
+                int firstBin = binCount;
+                for (int i = 0; i < group.size(); i++) 
+                {
+                    Parcel* p = group.get(i);
+                    int fit = -1;
+                    for (int b = firstBin; b < binCount && fit == -1; b++) 
+                    {
+                        TripBin* bin = bins[b];
+                        if (bin->parcels.size() < bin->rider->capacity && bin->load + p->weight <= bin->rider->maxWeight) 
+                        fit = b;
+                    }
+                    if (fit == -1) 
+                    {
+                        Rider* r = findIdleRider(p->priority);
+                        if (!r) { held.add(p); continue; }
+                        riders.reserve(r); // Keep it out of reach of the next bins
+                        if (binCount == binCapacity) 
+                        {
+                            TripBin** grown = new TripBin*[binCapacity * 2];
+                            for (int b = 0; b < binCount; b++) grown[b] = bins[b];
+                            delete[] bins; 
+                            bins = grown; 
+                            binCapacity *= 2;
+                        }
+                        fit = binCount++;
+                        bins[fit] = new TripBin();
+                        bins[fit]->rider = r;
+                        bins[fit]->hub = hub;
+                    }
+                    bins[fit]->parcels.add(p);
+                    bins[fit]->load += p->weight;
+                }
+                delete groups[g];
+            }
+            delete[] groups;
+            
+            for (int i = 0; i < held.size(); i++) 
+            queue.insert(held.get(i));
+            sum.heldBack += held.size();
+        }
+        
+        // Riders stay reserved until every hub is packed
+        planTours(bins, binCount, sum);
+        for (int b = 0; b < binCount; b++) 
+        {
+            riders.unreserve(bins[b]->rider);
+            dispatchTrip(*bins[b], departMinute);
+            sum.parcels += bins[b]->parcels.size();
+            sum.trips++;
+            delete bins[b];
+        }
+        delete[] bins;
+        return sum;
+    }
+    
+    void consolidateInteractive() 
+    {
+        if(!isAdmin()) { cout << "Access Denied.\n"; pauseFunc(); return; }
+        clearScreen();
+        cout << "\n   [ CONSOLIDATED DISPATCH ]\n";
+        ConsolidationSummary sum = consolidateAndDispatch();
+        cout << "   Parcels dispatched: " << sum.parcels << "\n";
+        cout << "   Rider trips:        " << sum.trips << "\n";
+        if(sum.trips > 0) 
+        cout << "   Parcels per trip:   " << fixed << setprecision(2) << (double)sum.parcels / sum.trips 
+             << "  (" << sum.parcels - sum.trips << " trips saved)\n";
+        cout.unsetf(ios::fixed); 
+        cout << setprecision(6);
+        if(sum.trips > 0) 
+        cout << "   Tour length:        " << sum.tourKm << " km (nearest-neighbour: " << sum.greedyKm << " km, planned in " 
+             << fixed << setprecision(1) << sum.tourMs << " ms)\n";
+        cout.unsetf(ios::fixed); 
+        cout << setprecision(6);
+        cout << "   Still waiting:      " << sum.heldBack << " (no idle rider)\n";
+        pauseFunc();
+    }
+    
+    void batchDispatchInteractive() 
+    {
+        if(!isAdmin()) { cout << "Access Denied.\n"; pauseFunc(); return; }
+        clearScreen();
+        cout << "\n   [ BATCH DISPATCH ]\n";
+        int mode, limit = 0; double budget;
+        cout << "   1. Network-wide urgency order (single thread)\n";
+        cout << "   2. Zone-sharded workers (one thread per zone)\n";
+        cout << "   Mode: "; cin >> mode;
+        if (mode != 2) 
+        { 
+            cout << "   Max parcels (0 = all): "; cin >> limit; 
+        }
+        cout << "   Time budget in ms (0 = none): "; cin >> budget;
+        
+        BatchDispatchSummary sum = (mode == 2) ? dispatchSharded(budget) : dispatchBatch(limit, budget);
+        
+        cout << "\n   Dispatched:  " << sum.dispatched << "\n";
+        if (mode == 2) 
+        cout << "   Workers:     " << sum.workers << " (" << sum.stolen << " parcels stolen across zones)\n";
+        cout << "   Returned:    " << sum.returned << " (no route)\n";
+        cout << "   Waiting:     " << sum.remaining << "\n";
+        cout << "   SLA Missed:  " << sum.late << "\n";
+        cout << "   Time:        " << fixed << setprecision(1) << sum.elapsedMs << " ms";
+        if (sum.elapsedMs > 0) 
+        cout << " (" << setprecision(0) << (sum.dispatched + sum.returned) * 1000.0 / sum.elapsedMs << " parcels/s)";
+        cout << "\n";
+        cout.unsetf(ios::fixed); 
+        cout << setprecision(6);
+        if (sum.fleetFull) cout << "   >> Stopped: no suitable rider available.\n";
+        if (sum.outOfTime) cout << "   >> Stopped: time budget reached.\n";
+        pauseFunc();
+    }
+
     void showMap() 
     { 
         map.displayNetwork(); 
@@ -1959,18 +7245,25 @@ public:
         UndoAction act;
         if(undoStack.pop(act)) 
         {
-            Parcel* p = database.search(act.parcelId);
+            Parcel* p = database.get(act.parcel);
             if(p) 
             {
                 if(act.type == "ADD") 
                 {
+                    // Stays in the database so it can still be tracked as cancelled
+                    dequeueFromHub(p);
                     p->updateStatus(STATUS_CANCELLED, "Undo: Creation Reverted", "N/A");
                     cout << ">> Undo Add: Parcel " << p->id << " marked as cancelled.\n";
                 } 
                 else if (act.type == "DISPATCH") 
                 {
+                    // Give the rider its room back and take the parcel off the shipping list,
+                    // so a later dispatch starts from a clean slate
+                    if (p->assignedRider != "") 
+                    releaseRider(p);
+                    shippingList.remove(p);
                     p->updateStatus(STATUS_WAREHOUSE, "Undo: Dispatch Reverted", "Warehouse");
-                    p->arrivalTime = 0; sortingQueue.insert(p); 
+                    p->arrivalTime = 0; enqueueAtHub(p); 
                     cout << ">> Undo Dispatch: Parcel " << p->id << " returned to warehouse.\n";
                 }
             }
@@ -2081,6 +7374,22 @@ public:
     void listAll() 
     { 
         if(!isAdmin()) { cout << "Restricted to Admins.\n"; pauseFunc(); return; }
+        
+        clearScreen();
+        cout << "   [1] All Parcels  [2] By Destination City  [3] By Destination Zone\n   Choice: ";
+        int choice; cin >> choice;
+        if (choice == 2 || choice == 3) 
+        {
+            // Read straight from the database's destination / zone index
+            string name;
+            cout << "   Enter " << (choice == 2 ? "City" : "Zone (e.g. Zone A)") << ": "; 
+            cin.ignore(); getline(cin, name);
+            ParcelArrayList found;
+            if (choice == 2) database.collectDestination(name, found);
+            else database.collectZone(name, found);
+            database.printList(found);
+        }
+        else 
         database.printAll(); 
         pauseFunc(); 
     }
@@ -2147,6 +7456,7 @@ public:
                map.addRoad(u, v, stoi(wStr));
             }
         }
+        setupHubs();
         
         // Read Users
         while(getline(f, line)) 
@@ -2172,7 +7482,7 @@ public:
             Parcel* newP = new Parcel(id, dest, w, p, zone);
             newP->status = s;
             database.insert(id, newP);
-            if(s == STATUS_WAREHOUSE) sortingQueue.insert(newP);
+            if(s == STATUS_WAREHOUSE) enqueueAtHub(newP);
             if(s >= STATUS_LOADING && s <= STATUS_DELIVERY_ATTEMPT) shippingList.pushBack(newP);
         }
             
@@ -2185,12 +7495,178 @@ public:
 
 
     
+    void manageHubsInteractive() 
+    {
+        if(!isAdmin()) { cout << "Access Denied.\n"; pauseFunc(); return; }
+        clearScreen();
+        cout << "\n   [ WAREHOUSE HUBS ]\n";
+        for(int h=0; h<map.getHubCount(); h++) 
+        {
+            cout << "   " << h << ". " << hubName(h) << " - ";
+            if(map.isHubOpen(h)) { setColor(COLOR_GREEN); cout << "OPEN"; } 
+            else { setColor(COLOR_RED); cout << "CLOSED"; }
+            resetColor();
+            cout << " (" << hubQueues.at(h).size() << " waiting)\n";
+        }
+        cout << "\n   1. Add Hub   2. Open/Close Hub\n   Select: ";
+        int choice; cin >> choice;
+        
+        if(choice == 1) 
+        {
+            map.printGraph();
+            cout << "   City ID: "; int c; cin >> c;
+            if(c < 0 || c >= map.cityCount) { cout << "Invalid City.\n"; pauseFunc(); return; }
+            int slot = map.addHub(c);
+            cout << ">> " << hubName(slot) << " is now a hub.\n";
+        } 
+        else if(choice == 2) 
+        {
+            cout << "   Hub ID: "; int h; cin >> h;
+            if(h < 0 || h >= map.getHubCount()) { cout << "Invalid Hub.\n"; pauseFunc(); return; }
+            bool open = !map.isHubOpen(h);
+            map.setHubOpen(h, open);
+            cout << ">> " << hubName(h) << " hub " << (open ? "opened" : "closed") << ".\n";
+            
+            if(!open) 
+            {
+                // Hand the waiting parcels over to their next nearest open hub
+                HubQueue& queue = hubQueues.at(h);
+                ParcelArrayList stranded;
+                int moved = 0;
+                while(!queue.isEmpty()) 
+                {
+                    Parcel* p = queue.extractMax();
+                    if(enqueueAtHub(p)) moved++;
+                    else stranded.add(p);
+                }
+                for(int i=0; i<stranded.size(); i++) queue.insert(stranded.get(i));
+                cout << ">> " << moved << " waiting parcel(s) moved to other hubs";
+                if(stranded.size() > 0) cout << ", " << stranded.size() << " held until a hub can reach them";
+                cout << ".\n";
+            }
+        }
+        else cout << ">> Invalid Choice.\n";
+        pauseFunc();
+    }
+    
+    // Choose how hub queues order parcels and show dispatch SLA performance
+    void schedulingInteractive() 
+    {
+        if(!isAdmin()) { cout << "Access Denied.\n"; pauseFunc(); return; }
+        clearScreen();
+        string names[3] = { "Priority (Indexed Heap)", "Priority (Bucket Queue)", "SLA Deadline (Earliest First)" };
+        string levels[4] = { "", "Standard", "Express", "Urgent" };
+        
+        cout << "\n   [ DISPATCH SLA REPORT ]\n";
+        int totalLate = 0, total = 0;
+        for(int i=1; i<=3; i++) 
+        {
+            int n = sla.onTime[i] + sla.late[i];
+            total += n; 
+            totalLate += sla.late[i];
+            cout << "   " << setw(9) << left << levels[i] << right << " SLA " << setw(3) << Parcel::slaSeconds(i) << "s: "
+                 << sla.onTime[i] << " on time, ";
+            if(sla.late[i] > 0) setColor(COLOR_RED);
+            cout << sla.late[i] << " missed"; resetColor();
+            if(n > 0) cout << " (" << fixed << setprecision(1) << 100.0 * sla.late[i] / n << "%)";
+            cout << "\n";
+        }
+        cout.unsetf(ios::fixed); 
+        cout << setprecision(6);
+        cout << "   Total: " << totalLate << " of " << total << " dispatches missed their deadline.\n";
+        
+        cout << "\n   [ SCHEDULING MODE ]\n";
+        cout << "   Current: " << names[hubQueues.getKind()] << "\n\n";
+        for(int i=0; i<3; i++) cout << "   " << i << ". " << names[i] << "\n";
+        cout << "   Select (other = keep): ";
+        int choice; cin >> choice;
+        if(choice >= QUEUE_KIND_HEAP && choice <= QUEUE_KIND_DEADLINE) 
+        {
+            hubQueues.setKind(choice);
+            cout << ">> Scheduling mode set to " << names[choice] << ".\n";
+        }
+        pauseFunc();
+    }
+    
+    void configureRoutingEngine() 
+    {
+        if(!isAdmin()) { cout << "Access Denied.\n"; pauseFunc(); return; }
+        clearScreen();
+        cout << "\n   [ ROUTING ENGINE ]\n";
+        string names[4] = { "Dijkstra (Hub Trees)", "Contraction Hierarchy", "Zone Overlay", "All-Pairs Distance Matrix" };
+        cout << "   Current: " << names[map.getRoutingEngine()] << "\n\n";
+        for(int i=0; i<4; i++) cout << "   " << i << ". " << names[i] << "\n";
+        cout << "   Select: ";
+        int choice; cin >> choice;
+        if(choice >= ROUTE_ENGINE_DIJKSTRA && choice <= ROUTE_ENGINE_MATRIX) 
+        {
+            map.setRoutingEngine(choice);
+            cout << ">> Routing Engine Updated.\n";
+        }
+        else cout << ">> Invalid Choice.\n";
+        pauseFunc();
+    }
+    
+    void runBenchmarks() 
+    {
+        if(!isAdmin()) { cout << "Access Denied.\n"; pauseFunc(); return; }
+        clearScreen();
+        cout << "\n   [ PERFORMANCE BENCHMARKS ]\n";
+        cout << "   1. Routing: Dijkstra vs Contraction Hierarchy vs Zone Overlay\n";
+        cout << "   2. All-Pairs Distance Matrix (Blocked Floyd-Warshall)\n";
+        cout << "   3. Sorting Queue: Indexed Heap vs Bucket Queue\n";
+        cout << "   4. Parcel Database Stress Test (10M entries)\n";
+        cout << "   5. Parcel Search: Swiss Table vs Quadratic Probing\n";
+        cout << "   6. Lifecycle Ticks (1M parcels in transit)\n";
+        cout << "   Select: ";
+        int choice; cin >> choice;
+        switch(choice) 
+        {
+            case 1: benchmarkRouting(150, 500); break;
+            case 2: benchmarkMatrix(2000); break;
+            case 3: benchmarkSortingQueues(1000000); break;
+            case 4: benchmarkParcelTable(10000000); break;
+            case 5: benchmarkParcelSearch(1 << 21); break;
+            case 6: benchmarkLifecycle(1000000, 3600); break;
+            default: cout << ">> Invalid Choice.\n";
+        }
+        pauseFunc();
+    }
+    
+    // Re-prioritise a waiting parcel in place; it moves within its hub queue immediately
+    void changePriorityInteractive() 
+    {
+        if(!isAdmin()) { cout << "Access Denied.\n"; pauseFunc(); return; }
+        clearScreen();
+        string id; int prio;
+        cout << "\n   [ CHANGE PRIORITY ]\n";
+        cout << "   Parcel ID: "; cin >> id;
+        Parcel* p = database.search(id);
+        if(!p || p->status != STATUS_WAREHOUSE) 
+        {
+            cout << ">> Error: Parcel not waiting at a hub.\n";
+            pauseFunc();
+            return;
+        }
+        cout << "   New Priority (1=Std, 2=Exp, 3=Urg): "; cin >> prio;
+        if(prio < 1 || prio > 3) { cout << ">> Invalid Priority.\n"; pauseFunc(); return; }
+        
+        int old = p->priority;
+        p->setPriority(prio);
+        if(p->originHub >= 0 && p->originHub < hubQueues.size()) 
+        hubQueues.at(p->originHub).update(p);
+        p->history->addEvent("Priority changed from " + to_string(old) + " to " + to_string(prio), "Warehouse");
+        cout << ">> Parcel " << id << " is now priority " << prio << ".\n";
+        pauseFunc();
+    }
+    
     void cancelParcel(string id) 
     {
         clearScreen();
         Parcel* p = database.search(id);
         if(p && p->status <= STATUS_WAREHOUSE) 
         {
+            dequeueFromHub(p);
             p->updateStatus(STATUS_CANCELLED, "Cancelled by User", "Warehouse");
             cout << ">> Parcel " << id << " cancelled.\n";
         } 
@@ -2201,66 +7677,92 @@ public:
     }
 };
 
-void ParcelLinkedList::updateLifecycle(long long currentTime, LogisticsEngine* engine) 
+// Only parcels whose event is due are touched, so a tick costs O(due events * log n) however
+// many parcels are still listed. The due ones are taken out before any is advanced, so a
+// parcel moves at most one step per tick, as with the old walk over the whole list. An event
+// can be stale (the parcel was cancelled, reported missing, or rerouted to a later arrival),
+// so each one is checked against the parcel again when it fires.
+int ParcelLinkedList::updateLifecycle(long long currentTime, LogisticsEngine* engine) 
 {
-    ParcelNode* curr = head;
-    while(curr) 
+    ParcelArrayList due;
+    while (!timers.isEmpty() && timers.peekMin()->nextEventTime <= currentTime) 
+    due.add(timers.extractMin());
+    
+    int advanced = 0;
+    for (int i = 0; i < due.size(); i++) 
     {
-        Parcel* p = curr->data;
-        if (p->status == STATUS_LOADING) 
+        Parcel* p = due.get(i);
+        long long at = eventTime(p);
+        if (at == -1) 
+        continue;
+        if (at <= currentTime) 
         {
-            if (currentTime >= p->lastUpdateTime + 5) 
-            {
-                p->updateStatus(STATUS_IN_TRANSIT, "Vehicle Departed", "On Road");
-            }
+            advance(p, currentTime, engine);
+            advanced++;
+            at = eventTime(p);
+        }
+        if (at != -1) 
+        timers.schedule(p, at);
+    }
+    return advanced;
+}
+
+void ParcelLinkedList::advance(Parcel* p, long long currentTime, LogisticsEngine* engine) 
+{
+    if (p->status == STATUS_LOADING) 
+    {
+        if (currentTime >= p->lastUpdateTime + 5) 
+        {
+            p->updateStatus(STATUS_IN_TRANSIT, "Vehicle Departed", "On Road");
+            p->signalLossTime = sampleSignalLoss(currentTime);
         }
-        else if (p->status == STATUS_IN_TRANSIT) 
+    }
+    else if (p->status == STATUS_IN_TRANSIT) 
+    {
+        if (currentTime >= p->signalLossTime && p->signalLossTime < p->arrivalTime) 
         {
-            if (rand() % 1000 == 0) 
+            p->updateStatus(STATUS_MISSING, "Signal Lost - Investigation Started", "Unknown");
+            // Update rider: just release capacity
+            if(engine && p->assignedRider != "")
             {
-                p->updateStatus(STATUS_MISSING, "Signal Lost - Investigation Started", "Unknown");
-                // Update rider: just release capacity
-                if(engine && p->assignedRider != "")
-                {
-                    engine->releaseRider(p->assignedRider);
-                }
+                engine->releaseRider(p);
             }
-            else if (currentTime >= p->arrivalTime) 
+        }
+        else if (currentTime >= p->arrivalTime) 
+        {
+            p->updateStatus(STATUS_DELIVERY_ATTEMPT, "Arrived at Destination Hub", p->destination);
+        }
+    }
+    else if (p->status == STATUS_DELIVERY_ATTEMPT) 
+    {
+        if (rand() % 10 < 8) 
+        {
+            p->updateStatus(STATUS_DELIVERED, "Handed to Recipient", "Doorstep");
+            // Update rider: just release capacity
+            if(engine && p->assignedRider != "")
             {
-                p->updateStatus(STATUS_DELIVERY_ATTEMPT, "Arrived at Destination Hub", p->destination);
+                engine->releaseRider(p);
             }
-        }
-        else if (p->status == STATUS_DELIVERY_ATTEMPT) 
+        } 
+        else 
         {
-            if (rand() % 10 < 8) 
+            p->deliveryAttempts++;
+            if (p->deliveryAttempts >= 3) 
             {
-                p->updateStatus(STATUS_DELIVERED, "Handed to Recipient", "Doorstep");
+                p->updateStatus(STATUS_RETURNED, "Max Attempts Reached - RTS", "Local Hub");
                 // Update rider: just release capacity
                 if(engine && p->assignedRider != "")
                 {
-                    engine->releaseRider(p->assignedRider);
+                    engine->releaseRider(p);
                 }
             } 
             else 
             {
-                p->deliveryAttempts++;
-                if (p->deliveryAttempts >= 3) 
-                {
-                    p->updateStatus(STATUS_RETURNED, "Max Attempts Reached - RTS", "Local Hub");
-                    // Update rider: just release capacity
-                    if(engine && p->assignedRider != "")
-                    {
-                        engine->releaseRider(p->assignedRider);
-                    }
-                } 
-                else 
-                {
-                    p->updateStatus(STATUS_IN_TRANSIT, "Recipient Unavailable - Retrying", "Local Hub");
-                    p->arrivalTime = currentTime + 5; 
-                }
+                p->updateStatus(STATUS_IN_TRANSIT, "Recipient Unavailable - Retrying", "Local Hub");
+                p->arrivalTime = currentTime + 5; 
+                p->signalLossTime = sampleSignalLoss(currentTime);
             }
         }
-        curr = curr->next;
     }
 }
 
@@ -2331,6 +7833,13 @@ int main()
                     cout << "   12. Add New City\n";
                     cout << "   13. Add New Road\n";
                     cout << "   14. Block/Unblock Road\n";
+                    cout << "   15. Routing Engine\n";
+                    cout << "   16. Performance Benchmarks\n";
+                    cout << "   17. Manage Hubs\n";
+                    cout << "   18. Batch Dispatch\n";
+                    cout << "   19. Change Parcel Priority\n";
+                    cout << "   20. Scheduling Mode & SLA Report\n";
+                    cout << "   21. Consolidated Dispatch (Multi-Parcel Trips)\n";
                     
                     setColor(COLOR_RED); cout << "\n   99. LOGOUT\n"; resetColor();
                 } 
@@ -2386,6 +7895,13 @@ int main()
                         case 12: engine.addCityInteractive(); break;
                         case 13: engine.addRoadInteractive(); break;
                         case 14: engine.blockRoadInteractive(); break;
+                        case 15: engine.configureRoutingEngine(); break;
+                        case 16: engine.runBenchmarks(); break;
+                        case 17: engine.manageHubsInteractive(); break;
+                        case 18: engine.batchDispatchInteractive(); break;
+                        case 19: engine.changePriorityInteractive(); break;
+                        case 20: engine.schedulingInteractive(); break;
+                        case 21: engine.consolidateInteractive(); break;
                     }
                 }
                 else
@@ -2427,4 +7943,4 @@ int main()
 
 
 
-}
\ No newline at end of file
+}
\ No newline at end of file